@@ -0,0 +1,65 @@
+#ifndef BINARY_COPY_READER_H
+#define BINARY_COPY_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct pg_conn;
+
+namespace Temporium {
+
+// Чтение COPY (...) TO STDOUT (FORMAT binary) через libpq на отдельном соединении.
+// Кортежи разбираются вручную: длина и значение поля в сетевом порядке байт,
+// без текстового представления и его разбора. Значения полей текущего кортежа
+// действительны до следующего next().
+class BinaryCopyReader {
+public:
+    explicit BinaryCopyReader(const std::string& conn_string);
+    ~BinaryCopyReader();
+    BinaryCopyReader(const BinaryCopyReader&) = delete;
+    BinaryCopyReader& operator=(const BinaryCopyReader&) = delete;
+
+    bool isConnected() const;
+    const std::string& errorString() const { return error_; }
+
+    // Команда без строк результата (BEGIN, SET TRANSACTION SNAPSHOT, COMMIT)
+    bool exec(const std::string& sql);
+    // Запуск COPY для запроса select_sql
+    bool start(const std::string& select_sql);
+    // Следующий кортеж; false — данные кончились или ошибка (см. failed())
+    bool next();
+    bool failed() const { return failed_; }
+
+    size_t fieldCount() const { return fields_.size(); }
+    bool isNull(size_t i) const { return fields_[i].size < 0; }
+    // Типы полей должны совпадать с типами столбцов запроса (int4, float8, bool, text)
+    std::string_view text(size_t i) const;
+    int32_t int4(size_t i) const;
+    double float8(size_t i) const;
+    bool boolean(size_t i) const;
+
+private:
+    struct Field {
+        const char* data;
+        int32_t size;       // -1 — NULL
+    };
+
+    bool fail(const std::string& message);
+    bool parseTuple(const char* data, size_t size);
+    void releaseBuffer();
+
+    pg_conn* conn_ = nullptr;
+    char* buffer_ = nullptr;        // Текущее сообщение PQgetCopyData
+    bool headerRead_ = false;
+    bool copying_ = false;
+    bool failed_ = false;
+    std::vector<Field> fields_;
+    std::string error_;
+};
+
+} // namespace Temporium
+
+#endif // BINARY_COPY_READER_H
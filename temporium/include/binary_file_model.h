@@ -0,0 +1,78 @@
+#ifndef BINARY_FILE_MODEL_H
+#define BINARY_FILE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QFile>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "types.h"
+
+namespace Temporium {
+
+// Модель просмотра бинарного файла экспорта: файл отображается в память,
+// запись декодируется только при обращении к её строке. Последние
+// CACHE_SIZE декодированных строк хранятся в LRU-кэше.
+class BinaryFileModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        ColName = 0,
+        ColDisk,
+        ColRam,
+        ColVram,
+        ColGenre,
+        ColCompleted,
+        ColUrl,
+        ColumnCount
+    };
+
+    static constexpr size_t CACHE_SIZE = 512;
+
+    explicit BinaryFileModel(QObject* parent = nullptr);
+
+    // Открывает и отображает файл; при ошибке текст причины в errorString()
+    bool open(const QString& filename);
+    QString errorString() const { return error_; }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Поиск подстроки в названии без учёта регистра, начиная с записи from
+    // и по кругу; -1 — не найдено. Читает названия прямо из отображения, кэш не трогает
+    int findName(const QString& text, int from) const;
+    // Записи с несовпавшей CRC32C подсвечиваются
+    void setDamagedRecords(const std::vector<uint32_t>& damaged);
+
+private:
+    // Декодированные поля, которые показывает таблица
+    struct Row {
+        QString name;
+        QString genre;
+        QString url;
+        double disk_space = 0;
+        double ram_usage = 0;
+        double vram_required = 0;
+        bool completed = false;
+    };
+
+    const BinaryGameRecord* recordAt(int row) const;
+    const Row& rowAt(int row) const;
+
+    QFile file_;
+    const uchar* records_ = nullptr;    // Начало записей в отображении
+    int recordCount_ = 0;
+    QString error_;
+    std::vector<bool> damaged_;
+
+    mutable std::list<std::pair<int, Row>> cache_;      // Недавно использованные в начале
+    mutable std::unordered_map<int, std::list<std::pair<int, Row>>::iterator> cacheIndex_;
+};
+
+} // namespace Temporium
+
+#endif // BINARY_FILE_MODEL_H
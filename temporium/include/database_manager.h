@@ -3,9 +3,15 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <memory>
+#include <optional>
+#include <functional>
 #include <pqxx/pqxx>
 #include "types.h"
+#include "game_result_view.h"
+
+struct pg_conn;
 
 namespace Temporium {
 
@@ -19,6 +25,21 @@ enum class FileVerificationResult {
     READ_ERROR
 };
 
+// Ключ кэша проверенных файлов: путь и атрибуты файла на момент проверки.
+// Любое изменение файла меняет inode/размер/mtime, и файл проверяется заново.
+struct VerifiedFileKey {
+    std::string path;
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+    
+    bool operator==(const VerifiedFileKey& other) const {
+        return path == other.path && device == other.device && inode == other.inode &&
+               size == other.size && mtime_ns == other.mtime_ns;
+    }
+};
+
 // Статистика игр для отображения в статусбаре
 struct GameStats {
     int total_games = 0;
@@ -30,6 +51,83 @@ struct GameStats {
     int no_url_count = 0;
 };
 
+// Порядок выборки игр на сервере: столбец и направление, при равенстве — по id
+// в том же направлении. Каждому столбцу соответствует индекс (user_id, столбец, id),
+// поэтому страница читается отрезком индекса при любой глубине прокрутки.
+// Жанр упорядочивается по genre_id (группировка без JOIN), оценка без оценки — как -1
+struct GameSort {
+    enum Column {
+        ByName,
+        ByDiskSpace,
+        ByRamUsage,
+        ByVramRequired,
+        ByGenre,
+        ByRating
+    };
+    Column column = ByName;
+    bool descending = false;
+
+    bool operator==(const GameSort& other) const {
+        return column == other.column && descending == other.descending;
+    }
+    bool operator!=(const GameSort& other) const { return !(*this == other); }
+};
+
+// Ключ постраничной выборки игр: последняя загруженная строка в порядке GameSort
+struct GamePageKey {
+    bool valid = false;         // false — первая страница
+    std::string name;           // Для GameSort::ByName
+    double value = 0;           // Значение столбца для остальных порядков
+    int id = 0;
+};
+
+// Строка списка пользователей панели администратора (без хеша пароля)
+struct UserSummary {
+    int id = 0;
+    std::string username;
+    bool is_admin = false;
+    int games_count = 0;
+};
+
+// Ключ постраничной выборки пользователей: логин уникален, порядок по нему
+struct UserPageKey {
+    bool valid = false;         // false — первая страница
+    std::string username;
+};
+
+// Фасетные счётчики панели фильтров. Счётчик каждой фасеты считается по текущему
+// фильтру без её собственного условия — видно, сколько игр даст выбор другого значения.
+struct FacetCounts {
+    int total = 0;                          // Игр по всему фильтру
+    int all_genres = 0;                     // Без условия по жанру
+    int all_tags = 0;                       // Без условия по тегу
+    std::map<int, int> genres;              // genre_id -> количество
+    std::map<int, int> tags;                // tag_id -> количество
+    // [0] — нет, [1] — да
+    std::array<int, 2> completed{};
+    std::array<int, 2> favorite{};
+    std::array<int, 2> installed{};
+    std::array<int, 2> rated{};
+    // Корзины по *_FACET_EDGES (на одну больше числа границ)
+    std::array<int, DISK_FACET_EDGES.size() + 1> disk{};
+    std::array<int, RAM_FACET_EDGES.size() + 1> ram{};
+    std::array<int, VRAM_FACET_EDGES.size() + 1> vram{};
+};
+
+// Независимые чтения обновления окна; пустое поле — не запрошено или не получено
+struct RefreshReads {
+    enum Part : unsigned {
+        Count  = 1u << 0,   // Число игр по фильтру
+        Stats  = 1u << 1,
+        Tags   = 1u << 2,
+        Genres = 1u << 3
+    };
+    std::optional<int> games_count;
+    std::optional<GameStats> stats;
+    std::optional<std::vector<Tag>> tags;
+    std::optional<std::vector<Genre>> genres;
+};
+
 // Статистика по жанрам
 struct GenreStats {
     int genre_id;
@@ -51,8 +149,39 @@ public:
                  const std::string& user, 
                  const std::string& password);
     
+    // Второе подключение с параметрами primary для фоновых запросов (без инициализации схемы)
+    bool connectSecondary(const DatabaseManager& primary);
+    
     void disconnect();
     bool isConnected() const;
+    // Отмена выполняющегося запроса этого подключения; безопасно вызывать из другого потока
+    void cancelQuery();
+    
+    // Единица работы: операции DatabaseManager, вызванные, пока она жива, выполняются
+    // в одной транзакции и фиксируются одним commit(). Ошибка любого шага откатывает
+    // все шаги; без commit() единица откатывается при разрушении. Вложенная единица
+    // присоединяется к внешней, фиксирует внешняя. Транзакции с собственным уровнем
+    // изоляции (экспорт) внутри единицы недоступны.
+    class UnitOfWork {
+    public:
+        UnitOfWork(const UnitOfWork&) = delete;
+        UnitOfWork& operator=(const UnitOfWork&) = delete;
+        ~UnitOfWork();
+        // false — шаг не выполнен или фиксация не удалась (причина в getLastError())
+        bool commit();
+        
+    private:
+        friend class DatabaseManager;
+        explicit UnitOfWork(DatabaseManager& db);
+        void finish();
+        
+        DatabaseManager& db_;
+        bool owner_ = false;        // Внешняя единица: открыла общую транзакцию
+        bool finished_ = false;
+    };
+    UnitOfWork batch() { return UnitOfWork(*this); }
+    // Число выполненных COMMIT на этом подключении (для оценки фиксаций на правку)
+    uint64_t commitCount() const { return commit_count_; }
     
     // Инициализация таблиц
     bool initializeTables();
@@ -67,6 +196,13 @@ public:
     bool deleteUser(int user_id);
     bool isAdmin(int user_id);
     int getUserGamesCount(int user_id);
+    std::string getUsername(int user_id);
+    // Страница пользователей с числом игр одним запросом; search — подстрока логина
+    std::vector<UserSummary> getUserSummariesPage(const std::string& search, const UserPageKey& after,
+                                                  int limit, bool* ok = nullptr);
+    // Удаление нескольких пользователей одним запросом (администраторы не удаляются).
+    // Возвращает число удалённых, -1 — ошибка
+    int deleteUsers(const std::vector<int>& user_ids);
     bool changeUsername(int user_id, const std::string& new_username, const std::string& current_password);
     bool changePassword(int user_id, const std::string& new_password_hash);
     bool resetAdminCredentials();
@@ -74,7 +210,7 @@ public:
     // ============================================================
     // ОПЕРАЦИИ С ЖАНРАМИ (Таблица genres)
     // ============================================================
-    std::vector<Genre> getAllGenres();
+    std::vector<Genre> getAllGenres(bool* ok = nullptr);
     Genre getGenreById(int genre_id);
     Genre getGenreByName(const std::string& name);
     int addGenre(const std::string& name, const std::string& description = "");
@@ -84,7 +220,7 @@ public:
     // ============================================================
     // ОПЕРАЦИИ С ТЕГАМИ (Таблица tags)
     // ============================================================
-    std::vector<Tag> getUserTags(int user_id);
+    std::vector<Tag> getUserTags(int user_id, bool* ok = nullptr);
     Tag getTagById(int tag_id);
     Tag getTagByName(const std::string& name, int user_id);
     int addTag(const std::string& name, int user_id, const std::string& color = "#808080");
@@ -94,15 +230,57 @@ public:
     // ============================================================
     // ОПЕРАЦИИ С ИГРАМИ (Таблица games)
     // ============================================================
-    bool addGame(const Game& game);
-    bool updateGame(const Game& game);
+    // saved (если задан) получает сохранённую строку с жанром и тегами — для точечного обновления таблицы
+    bool addGame(const Game& game, Game* saved = nullptr);
+    bool updateGame(const Game& game, Game* saved = nullptr);
     bool deleteGame(int game_id, int user_id);
     bool deleteGameByName(const std::string& name, int user_id);
-    std::vector<Game> getAllGames(int user_id);
-    std::vector<Game> getFilteredGames(int user_id, const GameFilter& filter);
+    // Страница игр в порядке sort после ключа after (keyset-пагинация, теги одним запросом);
+    // filter == nullptr — все игры пользователя; ok == false — запрос не выполнен (ошибка или отмена)
+    // Строки читаются прямо из результата запроса, без копий (см. GameResultView)
+    GameResultView getGamesPage(int user_id, const GameFilter* filter, const GameSort& sort,
+                                const GamePageKey& after, int limit, bool* ok = nullptr);
+    int countGames(int user_id, const GameFilter* filter, bool* ok = nullptr);
+    // Чтения parts (RefreshReads::Part) одним конвейером libpq: запросы уходят разом,
+    // ответы приходят за один круг до сервера. on_part вызывается для каждого
+    // ответа по мере прихода (заполнено одно поле). Возвращает полученные части;
+    // 0 — конвейер недоступен (libpq без pipeline mode, нет подключения)
+    unsigned readPipelined(unsigned parts, int user_id, const GameFilter* filter,
+                           const std::function<void(const RefreshReads&)>& on_part);
+    // Все фасетные счётчики одним запросом с GROUPING SETS
+    FacetCounts getFacetCounts(int user_id, const GameFilter& filter, bool* ok = nullptr);
     Game getGameById(int game_id, int user_id);
     Game getGameByName(const std::string& name, int user_id);
     bool updateGameNotes(int game_id, int user_id, const std::string& notes);
+    // Полный текст заметок; списки игр возвращают только has_notes и notes_preview
+    std::string getGameNotes(int game_id, int user_id, bool* ok = nullptr);
+    
+    // Отложенная запись заметок и флагов: изменения копятся в очереди, повторная запись
+    // того же столбца игры заменяет прежнее значение. flushPendingWrites() пишет очередь
+    // одним UPDATE; до этого изменения видны только через pendingGameNotes().
+    // updateGame/updateGameNotes/deleteGame снимают из очереди изменения своей игры
+    enum class GameFlag { Favorite, Installed, Completed };
+    void queueGameNotes(int game_id, int user_id, const std::string& notes);
+    void queueGameFlag(int game_id, int user_id, GameFlag flag, bool value);
+    // Число незаписанных пар (игра, столбец)
+    size_t pendingWriteCount() const;
+    // Незаписанные заметки игры; nullptr — в очереди их нет
+    const std::string* pendingGameNotes(int game_id) const;
+    // false — запись не удалась, очередь сохранена для повтора
+    bool flushPendingWrites();
+    
+    // Пакетные операции над множеством игр: одно выражение с = ANY($1) на всё множество
+    // в одной транзакции. updated (если задан) получает изменённые строки с жанром и
+    // тегами — для точечного обновления таблицы
+    bool deleteGames(const std::vector<int>& game_ids, int user_id);
+    bool setGamesGenre(const std::vector<int>& game_ids, int user_id, int genre_id,
+                       GameResultView* updated = nullptr);
+    bool setGamesFlag(const std::vector<int>& game_ids, int user_id, GameFlag flag, bool value,
+                      GameResultView* updated = nullptr);
+    bool addTagToGames(const std::vector<int>& game_ids, int user_id, int tag_id,
+                       GameResultView* updated = nullptr);
+    bool removeTagFromGames(const std::vector<int>& game_ids, int user_id, int tag_id,
+                            GameResultView* updated = nullptr);
     
     // ============================================================
     // ОПЕРАЦИИ СО СВЯЗЬЮ ИГРА-ТЕГ (Таблица game_tags)
@@ -114,7 +292,7 @@ public:
     // ============================================================
     // СТАТИСТИКА И АНАЛИТИКА (Демо-запросы для ЛР6)
     // ============================================================
-    GameStats getGameStats(int user_id);
+    GameStats getGameStats(int user_id, bool* ok = nullptr);  // Все счётчики одним запросом с FILTER
     std::vector<GenreStats> getGenreStatistics(int user_id);  // Запрос с GROUP BY и агрегатными функциями
     std::vector<Game> getTopRatedGames(int user_id, int limit = 10);  // Запрос с ORDER BY и LIMIT
     std::vector<Game> getGamesWithTags(int user_id);  // Запрос с LEFT JOIN
@@ -130,9 +308,27 @@ public:
     // ============================================================
     bool exportToBinaryFile(const std::string& filename, int user_id);
     bool exportFilteredToBinaryFile(const std::string& filename, int user_id, const GameFilter& filter);
+    // Дифференциальный экспорт: только игры, изменённые/удалённые после базового экспорта
+    // (base_filename — полный экспорт или предыдущая дельта, зарегистрированные в этой БД)
+    bool exportDeltaToBinaryFile(const std::string& filename, int user_id, const std::string& base_filename);
     FileVerificationResult verifyBinaryFile(const std::string& filename);
     bool importFromBinaryFile(const std::string& filename, int user_id);
+    bool importFromBinaryFile(const std::string& filename, int user_id, FileVerificationResult& verification);
+    // Быстрая проверка по CRC32C каждой записи (без SHA-256); damaged — номера повреждённых записей
+    FileVerificationResult quickCheckBinaryFile(const std::string& filename, std::vector<uint32_t>* damaged = nullptr);
+    // Импорт уцелевших записей повреждённого файла; повреждённые пропускаются и перечисляются в damaged
+    bool salvageImportFromBinaryFile(const std::string& filename, int user_id, std::vector<uint32_t>& damaged);
+    // Восстановление: полный экспорт + цепочка дельт (файлы упорядочиваются по хешам баз)
+    bool importDeltaChain(const std::vector<std::string>& filenames, int user_id);
     std::vector<Game> readBinaryFile(const std::string& filename);
+    // Проверка и чтение за один проход: записи декодируются при вычислении хеша.
+    // Для файлов из кэша проверенных хеш повторно не считается.
+    FileVerificationResult readBinaryFile(const std::string& filename, std::vector<Game>& games);
+    // Поиск записи в файле по индексу футера за O(log n) чтений (без индекса — перебором).
+    // Целостность файла не проверяется; record_no — номер найденной записи.
+    bool lookupInBinaryFile(const std::string& filename, const std::string& name, Game& game,
+                            uint32_t* record_no = nullptr);
+    bool lookupInBinaryFile(const std::string& filename, int id, Game& game, uint32_t* record_no = nullptr);
     
     // Получение последней ошибки
     std::string getLastError() const;
@@ -140,13 +336,78 @@ public:
     
 private:
     std::unique_ptr<pqxx::connection> conn_;
+    std::string conn_string_;
     std::string last_error_;
+    pg_conn* pipeline_conn_ = nullptr;  // Отдельное подключение libpq для readPipelined
+    
+    // Транзакция одной операции: собственная pqxx::work либо общая транзакция активной
+    // единицы работы. Во втором случае commit() только отмечает шаг выполненным, а
+    // шаг, не дошедший до commit(), помечает единицу как неудавшуюся
+    class Work {
+    public:
+        explicit Work(DatabaseManager& db);
+        ~Work();
+        Work(const Work&) = delete;
+        Work& operator=(const Work&) = delete;
+        pqxx::work* operator->() { return txn_; }
+        pqxx::work& operator*() { return *txn_; }
+        void commit();
+        // Действие над состоянием в памяти после фиксации (вызывается после commit()):
+        // своя транзакция уже зафиксирована — сразу; в единице работы — после фиксации
+        // внешней транзакции, при её откате действие отбрасывается
+        void afterCommit(std::function<void()> action);
+        
+    private:
+        DatabaseManager& db_;
+        std::optional<pqxx::work> own_;
+        pqxx::work* txn_ = nullptr;
+        bool committed_ = false;
+    };
+    // Очередь отложенной записи: по игре, флаги -1 — не изменялись
+    struct PendingGameWrite {
+        int user_id = 0;
+        std::optional<std::string> notes;
+        int favorite = -1;
+        int installed = -1;
+        int completed = -1;
+    };
+    std::map<int, PendingGameWrite> pending_writes_;
+    
+    std::unique_ptr<pqxx::work> batch_work_;    // Транзакция активной единицы работы
+    int batch_depth_ = 0;
+    bool batch_failed_ = false;
+    std::vector<std::function<void()>> batch_after_commit_;    // Work::afterCommit внутри единицы
+    uint64_t commit_count_ = 0;
+    
+    pg_conn* pipelineConnection();
+    void closePipelineConnection();
     
     std::string buildFilterCondition(const GameFilter& filter, int user_id);
-    bool writeGamesToFile(const std::string& filename, const std::vector<Game>& games);
+    // Параметры потокового экспорта
+    struct StreamExportOptions {
+        int snapshot_user_id = 0;   // != 0: зарегистрировать файл в export_snapshots
+        std::string base_hash;      // Непустой: дельта относительно этого снимка
+    };
+    
+    // Потоковая запись выборки в файл: строки читаются курсором COPY и сразу
+    // кодируются/хешируются, память не зависит от размера коллекции
+    bool streamGamesToFile(const std::string& filename, const std::string& condition,
+                           const StreamExportOptions& options);
+    FileVerificationResult readBinaryFileWithHeader(const std::string& filename, std::vector<Game>& games,
+                                                    BinaryFileHeader& header);
+    FileVerificationResult scanRecordCrcs(const std::string& filename, std::vector<uint32_t>& damaged,
+                                          std::vector<Game>* intact);
+    bool applyDelta(const std::string& filename, const BinaryFileHeader& header,
+                    std::vector<Game>& games, int user_id);
     void ensureAdminExists();
     void ensureDefaultGenres();
     std::string aggregateGameTags(int game_id);
+    
+    // Кэш проверенных файлов (последние MAX_VERIFIED_FILES, новые в начале)
+    static constexpr size_t MAX_VERIFIED_FILES = 8;
+    std::vector<VerifiedFileKey> verified_files_;
+    bool isFileVerified(const VerifiedFileKey& key) const;
+    void rememberVerifiedFile(const VerifiedFileKey& key);
 };
 
 } // namespace Temporium
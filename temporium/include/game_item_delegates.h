@@ -0,0 +1,55 @@
+#ifndef GAME_ITEM_DELEGATES_H
+#define GAME_ITEM_DELEGATES_H
+
+#include <QStyledItemDelegate>
+#include <QColor>
+#include <QFont>
+#include <QString>
+
+namespace Temporium {
+
+// Делегаты столбцов таблицы игр: рисуют по «сырому» значению из
+// GameTableModel::ValueRole, шрифты и цвета общие на весь столбец.
+// Фон строки и выделение рисует стиль, как у обычной ячейки.
+
+// Оценка: цветной бейдж с числом (зелёный/жёлтый/красный), без оценки — «—»
+class RatingDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit RatingDelegate(QObject* parent = nullptr);
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    QFont font_;
+};
+
+// Значок-флаг (избранное, установлено): рисуется, только если значение true
+class FlagDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    FlagDelegate(const QString& glyph, const QColor& color, int pointSize, QObject* parent = nullptr);
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    QString glyph_;
+    QColor color_;
+    QFont font_;
+};
+
+// Ссылка: подчёркнутый «🔗 Открыть», если URL задан
+class LinkDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit LinkDelegate(QObject* parent = nullptr);
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    QFont font_;
+};
+
+} // namespace Temporium
+
+#endif // GAME_ITEM_DELEGATES_H
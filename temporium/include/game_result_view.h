@@ -0,0 +1,85 @@
+#ifndef GAME_RESULT_VIEW_H
+#define GAME_RESULT_VIEW_H
+
+#include <cstddef>
+#include <string_view>
+#include <pqxx/pqxx>
+
+namespace Temporium {
+
+// Разбор текстового представления поля через std::from_chars, без промежуточных
+// строк; NULL и нераспознанный текст дают fallback
+int fieldToInt(const pqxx::field& field, int fallback);
+double fieldToDouble(const pqxx::field& field, double fallback);
+bool fieldToBool(const pqxx::field& field, bool fallback);
+
+inline std::string_view fieldText(const pqxx::field& field) {
+    return field.is_null() ? std::string_view() : std::string_view(field.c_str(), field.size());
+}
+
+// Строки игр поверх pqxx::result без копирования: текст — string_view в буфер
+// результата, числа разбираются при обращении. Результат хранится внутри
+// (копирование дешёвое, буфер общий), представления живут, пока жив view.
+// Порядок столбцов — как в GAME_ROW_SELECT (database_manager.cpp).
+class GameResultView {
+public:
+    enum Column {
+        ColId = 0,
+        ColName,
+        ColDiskSpace,
+        ColRamUsage,
+        ColVramRequired,
+        ColGenreId,
+        ColGenre,
+        ColCompleted,
+        ColUrl,
+        ColUserId,
+        ColRating,
+        ColFavorite,
+        ColInstalled,
+        ColHasNotes,
+        ColNotesPreview,
+        ColTags
+    };
+
+    class Row {
+    public:
+        int id() const { return fieldToInt(row_[ColId], 0); }
+        std::string_view name() const { return fieldText(row_[ColName]); }
+        double diskSpace() const { return fieldToDouble(row_[ColDiskSpace], 0); }
+        double ramUsage() const { return fieldToDouble(row_[ColRamUsage], 0); }
+        double vramRequired() const { return fieldToDouble(row_[ColVramRequired], 0); }
+        int genreId() const { return fieldToInt(row_[ColGenreId], 0); }
+        std::string_view genre() const { return fieldText(row_[ColGenre]); }
+        bool completed() const { return fieldToBool(row_[ColCompleted], false); }
+        std::string_view url() const { return fieldText(row_[ColUrl]); }
+        int userId() const { return fieldToInt(row_[ColUserId], 0); }
+        int rating() const { return fieldToInt(row_[ColRating], -1); }
+        bool isFavorite() const { return fieldToBool(row_[ColFavorite], false); }
+        bool isInstalled() const { return fieldToBool(row_[ColInstalled], false); }
+        bool hasNotes() const { return fieldToBool(row_[ColHasNotes], false); }
+        std::string_view notesPreview() const { return fieldText(row_[ColNotesPreview]); }
+        std::string_view tags() const { return fieldText(row_[ColTags]); }
+
+    private:
+        friend class GameResultView;
+        explicit Row(pqxx::row row) : row_(std::move(row)) {}
+
+        pqxx::row row_;
+    };
+
+    GameResultView() = default;
+    explicit GameResultView(pqxx::result result) : result_(std::move(result)) {}
+
+    size_t size() const { return static_cast<size_t>(result_.size()); }
+    bool empty() const { return result_.empty(); }
+    Row operator[](size_t row) const { return Row(result_[static_cast<pqxx::result::size_type>(row)]); }
+    Row back() const { return (*this)[size() - 1]; }
+
+private:
+    pqxx::result result_;
+};
+
+} // namespace Temporium
+
+#endif // GAME_RESULT_VIEW_H
@@ -0,0 +1,163 @@
+#ifndef GAME_STORE_H
+#define GAME_STORE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "types.h"
+
+namespace Temporium {
+
+// Словарь строк: каждая различная строка хранится один раз,
+// строки таблицы ссылаются на неё по номеру
+class StringDictionary {
+public:
+    uint32_t intern(std::string_view text);
+    std::string_view at(uint32_t id) const { return strings_[id]; }
+    size_t size() const { return strings_.size(); }
+    void clear();
+    size_t memoryUsage() const;
+
+private:
+    std::deque<std::string> strings_;   // deque не перемещает элементы: ключи index_ не устаревают
+    std::unordered_map<std::string_view, uint32_t> index_;
+};
+
+// Компактное хранилище игр таблицы. Жанры и наборы тегов заносятся в словари,
+// атрибуты фиксированной ширины лежат в отдельных массивах по полю, а
+// уникальные строки (название, ссылка, начало заметок) — в общем буфере.
+// Полный текст заметок и tag_ids не хранятся. Строки читаются через GameView.
+class GameStore {
+public:
+    // Лёгкое представление строки: указатель на хранилище и номер строки.
+    // Действительно, пока строка не изменена и не удалена
+    class GameView {
+    public:
+        int id() const { return store_->ids_[row_]; }
+        std::string_view name() const { return store_->text(store_->names_[row_]); }
+        double diskSpace() const { return store_->diskSpace_[row_]; }
+        double ramUsage() const { return store_->ramUsage_[row_]; }
+        double vramRequired() const { return store_->vramRequired_[row_]; }
+        int genreId() const { return store_->genreIds_[row_]; }
+        uint32_t genreKey() const { return store_->genreRefs_[row_]; }
+        std::string_view genre() const { return store_->genres_.at(genreKey()); }
+        bool completed() const { return store_->flags_[row_] & FlagCompleted; }
+        std::string_view url() const { return store_->text(store_->urls_[row_]); }
+        int userId() const { return store_->userIds_[row_]; }
+        int rating() const { return store_->ratings_[row_]; }
+        bool isFavorite() const { return store_->flags_[row_] & FlagFavorite; }
+        bool isInstalled() const { return store_->flags_[row_] & FlagInstalled; }
+        bool hasNotes() const { return store_->flags_[row_] & FlagHasNotes; }
+        std::string_view notesPreview() const { return store_->text(store_->notesPreviews_[row_]); }
+        uint32_t tagsKey() const { return store_->tagRefs_[row_]; }
+        std::string_view tags() const { return store_->tagSets_.at(tagsKey()); }
+
+        // Полная копия для редактирования (notes и tag_ids пусты)
+        Game toGame() const;
+
+    private:
+        friend class GameStore;
+        GameView(const GameStore* store, size_t row) : store_(store), row_(row) {}
+
+        const GameStore* store_;
+        size_t row_;
+    };
+
+    size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+    GameView at(size_t row) const { return GameView(this, row); }
+    // Номер строки игры; -1 — нет в хранилище. Индекс id -> строка строится при первом
+    // поиске и сбрасывается вставкой или удалением в середине (они и так сдвигают все массивы)
+    int rowOfGame(int gameId) const;
+
+    // Поля строки без владения текстом: текст копируется в хранилище при добавлении
+    struct Fields {
+        int id = 0;
+        int user_id = 0;
+        int genre_id = 0;
+        double disk_space = 0;
+        double ram_usage = 0;
+        double vram_required = 0;
+        int rating = -1;
+        bool completed = false;
+        bool is_favorite = false;
+        bool is_installed = false;
+        bool has_notes = false;
+        std::string_view genre;
+        std::string_view tags;
+        std::string_view name;
+        std::string_view url;
+        std::string_view notes_preview;
+    };
+    static Fields fieldsOf(const Game& game);
+
+    void reserve(size_t count);
+    void append(const Fields& fields) { insert(size(), fields); }
+    void insert(size_t row, const Fields& fields);
+    void assign(size_t row, const Fields& fields);
+    void append(const Game& game) { append(fieldsOf(game)); }
+    void insert(size_t row, const Game& game) { insert(row, fieldsOf(game)); }
+    void assign(size_t row, const Game& game) { assign(row, fieldsOf(game)); }
+    void erase(size_t row) { erase(row, 1); }
+    // Удаление count строк подряд начиная с row
+    void erase(size_t row, size_t count);
+    // Очищает строки, словари и освобождает память
+    void clear();
+
+    const StringDictionary& genres() const { return genres_; }
+    const StringDictionary& tagSets() const { return tagSets_; }
+
+    // Байты, занятые массивами, буфером строк и словарями
+    size_t memoryUsage() const;
+
+private:
+    enum Flag : uint8_t {
+        FlagCompleted = 0x1,
+        FlagFavorite = 0x2,
+        FlagInstalled = 0x4,
+        FlagHasNotes = 0x8
+    };
+
+    // Участок общего буфера text_
+    struct TextRef {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    TextRef addText(std::string_view text);
+    std::string_view text(TextRef ref) const { return std::string_view(text_.data() + ref.offset, ref.size); }
+    void releaseText(size_t row);
+    void compactTextIfSparse();
+    void invalidateRowIndex() const;
+
+    std::vector<int32_t> ids_;
+    std::vector<int32_t> userIds_;
+    std::vector<int32_t> genreIds_;
+    std::vector<double> diskSpace_;
+    std::vector<double> ramUsage_;
+    std::vector<double> vramRequired_;
+    std::vector<int8_t> ratings_;
+    std::vector<uint8_t> flags_;
+    std::vector<uint32_t> genreRefs_;   // Номер в genres_
+    std::vector<uint32_t> tagRefs_;     // Номер в tagSets_ (строка тегов целиком: наборы повторяются)
+    std::vector<TextRef> names_;
+    std::vector<TextRef> urls_;
+    std::vector<TextRef> notesPreviews_;
+
+    std::string text_;
+    size_t deadText_ = 0;   // Байты text_ от изменённых и удалённых строк
+
+    StringDictionary genres_;
+    StringDictionary tagSets_;
+
+    mutable std::unordered_map<int32_t, uint32_t> rowIndex_;
+    mutable bool rowIndexValid_ = false;
+};
+
+} // namespace Temporium
+
+#endif // GAME_STORE_H
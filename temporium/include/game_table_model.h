@@ -0,0 +1,168 @@
+#ifndef GAME_TABLE_MODEL_H
+#define GAME_TABLE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QCollator>
+#include <QCollatorSortKey>
+#include <QColor>
+#include <optional>
+#include <vector>
+
+#include "database_manager.h"
+#include "game_store.h"
+
+namespace Temporium {
+
+// Модель таблицы игр: строки лежат в компактном GameStore, содержимое ячеек
+// (текст, цвета, подсказки) вычисляется в data() только для видимых строк.
+// Оценку, значки и ссылку рисуют делегаты (game_item_delegates.h) по ValueRole.
+// Строки подгружаются из БД страницами по мере прокрутки (canFetchMore/fetchMore)
+// в порядке GameSort, который выполняет сервер.
+class GameTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        ColId = 0,
+        ColName,
+        ColDisk,
+        ColRam,
+        ColVram,
+        ColGenre,
+        ColCompleted,
+        ColRating,
+        ColFavorite,
+        ColInstalled,
+        ColTags,
+        ColUrl,
+        ColumnCount
+    };
+
+    enum Role {
+        UrlRole = Qt::UserRole,         // Ссылка на игру (столбец ColUrl)
+        NotesRole = Qt::UserRole + 1,   // Начало заметок; полный текст — DatabaseManager::getGameNotes
+        GameIdRole = Qt::UserRole + 2,  // ID игры (любой столбец)
+        ValueRole = Qt::UserRole + 3    // Исходное значение для делегата (оценка, флаг, URL)
+    };
+
+    static constexpr int PAGE_SIZE = 200;
+
+    explicit GameTableModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    // Новый источник строк: модель сбрасывается и сразу загружает первую страницу.
+    // filter == nullptr — все игры пользователя. При ошибке запроса строки остаются
+    // прежними (если источник тот же пользователь), испускается loadFailed
+    bool setSource(DatabaseManager* dbManager, int userId, const GameFilter* filter);
+    // То же с уже загруженной первой страницей (например, полученной фоновым запросом)
+    void setSource(DatabaseManager* dbManager, int userId, const GameFilter* filter,
+                   const GameResultView& firstPage);
+    void clear();
+    // Порядок выборки на сервере; при смене источник перечитывается с первой страницы.
+    // Если перечитать не удалось, прежний порядок сохраняется
+    bool setSort(const GameSort& sort);
+    const GameSort& sort() const { return sort_; }
+    // Серверный порядок для столбца таблицы; nullopt — столбец сортируется только на клиенте
+    static std::optional<GameSort> serverSort(int column, Qt::SortOrder order);
+    // Точечные изменения после add/edit/delete без перезагрузки таблицы.
+    // upsertGame ставит строку на её место в порядке sort() и возвращает номер строки;
+    // -1 — строка лежит за пределами загруженных страниц и придёт при прокрутке
+    int upsertGame(const Game& game);
+    bool removeGame(int gameId);
+    // Пакетные изменения: удаление смежными диапазонами строк, замена — одним dataChanged.
+    // При порядке по названию строки updated сохраняют место (пакетные операции его не меняют)
+    void removeGames(const std::vector<int>& gameIds);
+    void updateGames(const GameResultView& updated);
+    int rowOfGame(int gameId) const;
+
+    // Копия строки для редактирования; для чтения полей дешевле store().at(row)
+    Game gameAt(int row) const;
+    const GameStore& store() const { return store_; }
+    // Время переноса последней загруженной страницы из результата запроса в store_
+    // (для отладочного оверлея); -1 — страниц ещё не было
+    qint64 lastPageMicros() const { return lastPageMicros_; }
+
+    // Сравнение строк по значению столбца (<0, 0, >0) — по числовым полям и
+    // заранее вычисленным ключам сопоставления, без форматирования текста
+    int compareRows(int left, int right, int column) const;
+
+signals:
+    // Запрос страницы не выполнен; загруженные строки и hasMore_ не тронуты
+    void loadFailed(const QString& error);
+
+private:
+    bool isBeyondLoaded(const Game& game) const;
+    bool rowLess(size_t row, const Game& game) const;
+    // Сравнение в порядке sort_: название или значение столбца, затем id
+    int compareSorted(std::string_view aName, double aValue, int aId,
+                      std::string_view bName, double bValue, int bId) const;
+    void resetSource(DatabaseManager* dbManager, int userId, const GameFilter* filter);
+    void appendPage(const GameResultView& page);
+    // Дополняет тексты и ключи сопоставления новыми записями словарей store_
+    void syncDictionaries();
+
+    GameStore store_;
+    QCollator collator_;
+    // Ключи сопоставления названий считаются один раз при загрузке строки (параллельно store_);
+    // жанры и наборы тегов — один раз на запись словаря, по её номеру
+    std::vector<QCollatorSortKey> nameSortKeys_;
+    std::vector<QString> genreTexts_;
+    std::vector<QString> tagTexts_;
+    std::vector<QCollatorSortKey> genreSortKeys_;
+    std::vector<QCollatorSortKey> tagSortKeys_;
+
+    // Параметры постраничной выборки
+    DatabaseManager* dbManager_ = nullptr;
+    int userId_ = 0;
+    bool filterActive_ = false;
+    GameFilter filter_;
+    GameSort sort_;
+    GamePageKey lastKey_;
+    bool hasMore_ = false;
+    qint64 lastPageMicros_ = -1;
+};
+
+// Сортировка таблицы игр на клиенте по нескольким столбцам.
+// Щелчок по заголовку делает столбец первичным ключом, прежние ключи
+// становятся вторичными (до MAX_SORT_KEYS); при равенстве — по ID.
+// Серверный порядок модели для этого не используется: на равных значениях
+// первичного столбца строки упорядочиваются по вторичным ключам.
+class GameSortProxyModel : public QSortFilterProxyModel {
+    Q_OBJECT
+
+public:
+    struct SortKey {
+        int column;
+        Qt::SortOrder order;
+    };
+
+    static constexpr size_t MAX_SORT_KEYS = 3;
+
+    explicit GameSortProxyModel(QObject* parent = nullptr);
+
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    const std::vector<SortKey>& sortKeys() const { return sortKeys_; }
+    void setSortKeys(const std::vector<SortKey>& keys);
+
+    // Сохранение/восстановление в QSettings: "столбец:порядок;..."
+    QString sortKeysToString() const;
+    static std::vector<SortKey> sortKeysFromString(const QString& text);
+
+protected:
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private:
+    std::vector<SortKey> sortKeys_;
+};
+
+} // namespace Temporium
+
+#endif // GAME_TABLE_MODEL_H
@@ -7,6 +7,9 @@
 #include <openssl/evp.h>
 #include <openssl/sha.h>
 #include <memory>
+#include <cstdint>
+#include <cstring>
+#include <array>
 
 namespace Temporium {
 
@@ -62,6 +65,28 @@ public:
         return bytesToHex(hash, hash_len);
     }
     
+    // Некриптографический 64-битный хеш FNV-1a (ключи индексов в файлах экспорта)
+    static uint64_t fnv1a64(const char* data, size_t length) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+    
+    // CRC32C (Castagnoli): аппаратно через SSE4.2, если доступно, иначе табличный вариант.
+    // crc — значение предыдущего вызова для вычисления по частям.
+    static uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0) {
+#if defined(__x86_64__) || defined(__i386__)
+        static const bool hardware = __builtin_cpu_supports("sse4.2");
+        if (hardware) {
+            return crc32cHardware(static_cast<const unsigned char*>(data), length, crc);
+        }
+#endif
+        return crc32cSoftware(static_cast<const unsigned char*>(data), length, crc);
+    }
+    
     // Преобразование байтов в hex-строку
     static std::string bytesToHex(const unsigned char* data, size_t length) {
         std::stringstream ss;
@@ -70,6 +95,98 @@ public:
         }
         return ss.str();
     }
+
+private:
+    static uint32_t crc32cSoftware(const unsigned char* data, size_t length, uint32_t crc) {
+        static const auto table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    value = (value & 1) ? (value >> 1) ^ 0x82F63B78u : value >> 1;
+                }
+                t[i] = value;
+            }
+            return t;
+        }();
+        crc = ~crc;
+        for (size_t i = 0; i < length; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+    
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("sse4.2")))
+    static uint32_t crc32cHardware(const unsigned char* data, size_t length, uint32_t crc) {
+        crc = ~crc;
+#if defined(__x86_64__)
+        uint64_t crc64 = crc;
+        while (length >= 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, data, sizeof(chunk));
+            crc64 = __builtin_ia32_crc32di(crc64, chunk);
+            data += 8;
+            length -= 8;
+        }
+        crc = static_cast<uint32_t>(crc64);
+#endif
+        while (length >= 4) {
+            uint32_t chunk;
+            std::memcpy(&chunk, data, sizeof(chunk));
+            crc = __builtin_ia32_crc32si(crc, chunk);
+            data += 4;
+            length -= 4;
+        }
+        while (length > 0) {
+            crc = __builtin_ia32_crc32qi(crc, *data);
+            ++data;
+            --length;
+        }
+        return ~crc;
+    }
+#endif
+};
+
+// Потоковое вычисление SHA-256: данные подаются частями по мере чтения/записи
+class Sha256Stream {
+public:
+    Sha256Stream() : ctx_(EVP_MD_CTX_new()), ok_(false) {
+        if (ctx_ != nullptr) {
+            ok_ = EVP_DigestInit_ex(ctx_, EVP_sha256(), nullptr) == 1;
+        }
+    }
+    
+    ~Sha256Stream() {
+        if (ctx_ != nullptr) {
+            EVP_MD_CTX_free(ctx_);
+        }
+    }
+    
+    Sha256Stream(const Sha256Stream&) = delete;
+    Sha256Stream& operator=(const Sha256Stream&) = delete;
+    
+    void update(const void* data, size_t length) {
+        if (ok_ && data != nullptr && length > 0) {
+            ok_ = EVP_DigestUpdate(ctx_, data, length) == 1;
+        }
+    }
+    
+    // Завершение вычисления; пустая строка при ошибке OpenSSL
+    std::string finalHex() {
+        unsigned char hash[SHA256_DIGEST_LENGTH];
+        unsigned int hash_len = 0;
+        if (!ok_ || EVP_DigestFinal_ex(ctx_, hash, &hash_len) != 1) {
+            ok_ = false;
+            return "";
+        }
+        ok_ = false;
+        return HashUtils::bytesToHex(hash, hash_len);
+    }
+    
+private:
+    EVP_MD_CTX* ctx_;
+    bool ok_;
 };
 
 } // namespace Temporium
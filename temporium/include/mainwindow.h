@@ -3,6 +3,7 @@
 
 #include <QMainWindow>
 #include <QTableWidget>
+#include <QTableView>
 #include <QPushButton>
 #include <QLineEdit>
 #include <QComboBox>
@@ -29,12 +30,26 @@
 #include <QScrollArea>
 #include <QSettings>
 #include <QKeyEvent>
+#include <QCloseEvent>
 #include <QDesktopServices>
 #include <QUrl>
 #include <QTextEdit>
 #include <QSpinBox>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include <atomic>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "database_manager.h"
+#include "game_table_model.h"
+#include "game_item_delegates.h"
+#include "binary_file_model.h"
+#include "user_list_model.h"
 #include "hash_utils.h"
 
 namespace Temporium {
@@ -48,6 +63,7 @@ public:
 
 protected:
     bool eventFilter(QObject* obj, QEvent* event) override;
+    void closeEvent(QCloseEvent* event) override;
 
 private slots:
     void onLogin();
@@ -61,15 +77,20 @@ private slots:
     
     void onApplyFilter();
     void onResetFilter();
+    void onFilterChanged();
+    void startFilterQuery();
     
     void onExportToFile();
     void onExportFilteredToFile();
+    void onExportDeltaToFile();
     void onImportFromFile();
+    void onImportDeltaChain();
     void onViewExportedFile();
     
     void onTableSelectionChanged();
-    void onTableCellClicked(int row, int column);
-    void onTableCellDoubleClicked(int row, int column);
+    void onTableCellClicked(const QModelIndex& index);
+    void onTableCellDoubleClicked(const QModelIndex& index);
+    void onGamesContextMenu(const QPoint& pos);
     void onToggleNotesPanel();
     void onSaveNotes();
     void onAbout();
@@ -88,12 +109,52 @@ private:
     void showLoginPage();
     void showMainPage();
     void updateGamesTable();
-    void updateGamesTable(const std::vector<Game>& games);
-    void updateStatusBar();
+    int currentGameRow() const;
+    // ID игр выделенных строк (в порядке выделения)
+    std::vector<int> selectedGameIds() const;
+    // Пакетные операции над выделением: один запрос, одна правка таблицы, одно обновление
+    void deleteSelectedGames(const std::vector<int>& gameIds);
+    void applyBulkUpdate(const std::function<bool(GameResultView*)>& update, unsigned refresh);
+    void selectGameRow(int row);
+    void restoreTableSort();
+    // Переносит первичный ключ сортировки таблицы в запрос страниц (GameTableModel::setSort)
+    void applyServerSort();
+    void updateStatusBar(int gamesCount);
     void updateButtonStates();
     void resetTableColumnWidths();
-    void updateTagsCombo();
-    void updateStats();
+    void updateTagsCombo(const std::vector<Tag>& tags);
+    void updateGenresCombo(const std::vector<Genre>& genres);
+    void updateStats(const GameStats& stats);
+    
+    void scheduleRefresh(unsigned flags);
+    void runScheduledRefresh();
+    
+    GameFilter readFilterPanel() const;
+    void requestFacets(const GameFilter& filter);
+    void applyFacetCounts(const FacetCounts& counts);
+    void updateDebugOverlay();
+    // Число COMMIT, выполненных последней правкой (с отметки commitsBefore)
+    void noteEditCommits(uint64_t commitsBefore);
+    
+    // Заметки не приходят со списком игр: они читаются по требованию и кэшируются
+    void showNotesInPanel(const Game& game);
+    void prefetchNotes(const Game& game);
+    void onNotesLoaded(int gameId, const std::optional<std::string>& notes);
+    bool loadNotes(const Game& game, std::string& notes);
+    const std::string* cachedNotes(int gameId);
+    void cacheNotes(int gameId, std::string notes);
+    void clearNotesCache();
+    
+    // Отложенная запись: заметки и флаги из таблицы сразу показываются в модели, а в базу
+    // уходят пачкой через WRITE_BEHIND_DELAY_MS после первого изменения, перед запросами,
+    // которые должны их видеть (фильтр, экспорт, импорт, обновление), и при выходе
+    static constexpr int WRITE_BEHIND_DELAY_MS = 1000;
+    void toggleGameFlag(const QModelIndex& index);
+    void onPendingWriteQueued();
+    bool flushPendingWrites();
+    void updatePendingWritesIndicator();
+    
+    void offerSalvageImport(const QString& filename);
     
     void connectToDatabase();
     void saveLastUsername();
@@ -111,11 +172,14 @@ private:
     
     // Главная страница
     QWidget* mainPage_;
-    QTableWidget* gamesTable_;
+    QTableView* gamesTable_;
+    GameTableModel* gamesModel_;
+    GameSortProxyModel* gamesProxy_;
     QLabel* userInfoLabel_;
     
     // Панель фильтров
     QGroupBox* filterGroupBox_;
+    QLineEdit* filterNameEdit_;
     QCheckBox* filterCompletedCheck_;
     QComboBox* filterCompletedCombo_;
     QCheckBox* filterGenreCheck_;
@@ -146,6 +210,11 @@ private:
     QPushButton* applyFilterButton_;
     QPushButton* resetFilterButton_;
     
+    // Гистограммы фасет по диапазонам диска/ОЗУ/видеопамяти
+    QLabel* diskFacetLabel_;
+    QLabel* ramFacetLabel_;
+    QLabel* vramFacetLabel_;
+    
     // Статистика внизу окна
     QLabel* statsLabel_;
     
@@ -155,6 +224,13 @@ private:
     QLabel* notesPanelTitle_;
     QPushButton* saveNotesButton_;
     int currentNotesGameId_;  // ID игры, для которой открыты заметки
+    int notesWaitingGameId_ = -1;  // Панель ждёт загрузки заметок этой игры
+    
+    // LRU-кэш полного текста заметок: недавно использованные в начале списка
+    static constexpr size_t NOTES_CACHE_SIZE = 32;
+    std::list<std::pair<int, std::string>> notesCache_;
+    std::unordered_map<int, std::list<std::pair<int, std::string>>::iterator> notesCacheIndex_;
+    std::unordered_set<int> notesInFlight_;  // Игры, заметки которых уже запрошены в фоне
     
     // Кнопки управления
     QPushButton* addButton_;
@@ -172,7 +248,9 @@ private:
     QAction* deleteAction_;
     QAction* exportAction_;
     QAction* exportFilteredAction_;
+    QAction* exportDeltaAction_;
     QAction* importAction_;
+    QAction* importChainAction_;
     QAction* viewExportedAction_;
     QAction* aboutAction_;
     QAction* adminAction_;
@@ -189,6 +267,61 @@ private:
     int lastClickedRow_;
     
     QSettings settings_;
+    
+    // Отложенное обновление: флаги копятся до конца текущего прохода цикла событий,
+    // затем каждая часть обновляется не более одного раза. Вспомогательные запросы
+    // идут на фоновом подключении параллельно с загрузкой таблицы.
+    enum RefreshFlag : unsigned {
+        RefreshTable  = 1u << 0,    // Первая страница таблицы
+        RefreshCount  = 1u << 1,    // Число игр в статусбаре
+        RefreshStats  = 1u << 2,    // Строка статистики
+        RefreshTags   = 1u << 3,    // Теги в фильтре
+        RefreshGenres = 1u << 4,    // Жанры в фильтре
+        RefreshFacets = 1u << 5,    // Счётчики фасет
+        RefreshAll    = (1u << 6) - 1
+    };
+    // Части RefreshReads, соответствующие флагам обновления
+    static unsigned refreshReadParts(unsigned flags);
+    // Чтение частей по одной; при ошибке (в том числе отмене, адресованной фильтру
+    // на том же подключении) запрос повторяется один раз
+    static RefreshReads loadRefreshResults(DatabaseManager& db, unsigned parts,
+                                           int userId, const GameFilter* filter);
+    void applyRefreshResults(const RefreshReads& results);
+    unsigned pendingRefresh_ = 0;
+    QElapsedTimer refreshLatency_;    // От запуска обновления до получения всех частей
+    int refreshPartsRequested_ = 0;
+    int refreshPartsRun_ = 0;
+    QLabel* gamesCountLabel_;
+    QTimer* writeBehindTimer_;
+    QLabel* pendingWritesLabel_;
+    bool flagWritesPending_ = false;  // В очереди есть флаги: после записи обновить статистику
+    // Списки для меню пакетных операций (обновляются вместе с фильтрами)
+    std::vector<Genre> genres_;
+    std::vector<Tag> userTags_;
+    
+    // Живая фильтрация: изменения панели копятся FILTER_DEBOUNCE_MS, затем первая страница
+    // запрашивается в фоне на отдельном подключении. Устаревший запрос отменяется на сервере,
+    // а его результат отбрасывается по номеру поколения.
+    static constexpr int FILTER_DEBOUNCE_MS = 250;
+    QTimer* filterDebounce_;
+    DatabaseManager filterDb_;
+    QThreadPool filterPool_;          // Один поток: запросы к filterDb_ идут строго по очереди
+    std::atomic<int> filterGeneration_{0};
+    int filterQueriesInFlight_ = 0;
+    QElapsedTimer filterLatency_;     // От последнего изменения панели до обновления таблицы
+    std::atomic<int> facetGeneration_{0};
+    std::optional<FacetCounts> lastFacets_;
+    
+    // Отладочный оверлей в статусбаре (включается переменной окружения TEMPORIUM_DEBUG_OVERLAY)
+    QLabel* debugOverlayLabel_;
+    qint64 lastFilterLatencyMs_ = -1;
+    qint64 lastRefreshLatencyMs_ = -1;
+    qint64 lastEditCommits_ = -1;
+    int filterQueriesCancelled_ = 0;
+    int filterResultsDiscarded_ = 0;
+    QElapsedTimer tableFpsTimer_;     // Окно замера частоты перерисовки таблицы
+    int tableFrames_ = 0;
+    double tableFps_ = -1;
 };
 
 // Диалог редактирования игры
@@ -219,17 +352,35 @@ private:
     int userId_;
 };
 
-// Диалог просмотра бинарного файла
+// Диалог просмотра бинарного файла: записи читаются лениво через BinaryFileModel,
+// целостность проверяется по CRC32C записей в фоне
 class BinaryFileViewDialog : public QDialog {
     Q_OBJECT
 
 public:
-    explicit BinaryFileViewDialog(const std::vector<Game>& games, 
+    explicit BinaryFileViewDialog(DatabaseManager* dbManager,
                                    const QString& filename,
                                    QWidget* parent = nullptr);
+    bool isFileOpen() const { return fileOpen_; }
+    QString errorString() const { return model_->errorString(); }
+    int recordCount() const { return model_->rowCount(); }
+
+private slots:
+    void onFind();
+    void onJumpToRow();
 
 private:
-    QTableWidget* table_;
+    void startVerification();
+    void showRow(int row);
+    
+    DatabaseManager* dbManager_;
+    QString filename_;
+    BinaryFileModel* model_;
+    bool fileOpen_;
+    QTableView* table_;
+    QLineEdit* findEdit_;
+    QSpinBox* jumpSpin_;
+    QLabel* verifyLabel_;
 };
 
 // Админская панель
@@ -248,13 +399,24 @@ private slots:
     void onChangeUsername();
     void onChangePassword();
     void onResetAdmin();
+    void onPageRequested(const UserPageKey& after);
 
 private:
     void updateUsersList();
+    void updateDeleteButton();
+    void showPageError(const std::string& error);
+    std::vector<UserSummary> selectedUsers() const;   // Выбранные, кроме администраторов
     
     DatabaseManager* dbManager_;
     int adminUserId_;
-    QTableWidget* usersTable_;
+    // Страницы списка грузятся в фоне на отдельном подключении
+    DatabaseManager loaderDb_;
+    QThreadPool loaderPool_;         // Один поток: запросы к loaderDb_ идут по очереди
+    int pageGeneration_ = 0;         // Ответы для прежнего поиска отбрасываются
+    UserListModel* usersModel_;
+    QTableView* usersTable_;
+    QLineEdit* searchEdit_;
+    QTimer* searchDebounce_;
     QPushButton* deleteButton_;
     QPushButton* refreshButton_;
     QPushButton* changeUsernameButton_;
@@ -0,0 +1,21 @@
+#ifndef THEME_H
+#define THEME_H
+
+#include <QString>
+
+namespace Temporium {
+
+// Цвета тёмной темы: таблицы стилей окна и цвета, которые модели и делегаты задают сами
+inline const QString DARK_BG = "#303030";
+inline const QString DARK_LIGHTER = "#404040";
+inline const QString DARK_BORDER = "#505050";
+inline const QString BORDER_COLOR = "#505050";
+inline const QString ACCENT_COLOR = "#03fce8";
+inline const QString ACCENT_DARKER = "#02d4c4";
+inline const QString TEXT_COLOR = "#ffffff";
+inline const QString TEXT_PRIMARY = "#ffffff";
+inline const QString TEXT_SECONDARY = "#b0b0b0";
+
+} // namespace Temporium
+
+#endif // THEME_H
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <cstdint>
 #include <cstring>
 
@@ -17,6 +18,14 @@ constexpr double MIN_DISK_SPACE = 0.1;
 constexpr double MIN_RAM_USAGE = 0.5;
 constexpr double MIN_VRAM_REQUIRED = 0.5;
 
+// Границы корзин гистограмм в панели фильтров (ГБ): корзина i — [EDGES[i-1], EDGES[i])
+constexpr std::array<double, 4> DISK_FACET_EDGES = {10.0, 25.0, 50.0, 100.0};
+constexpr std::array<double, 4> RAM_FACET_EDGES = {4.0, 8.0, 16.0, 32.0};
+constexpr std::array<double, 4> VRAM_FACET_EDGES = {2.0, 4.0, 8.0, 12.0};
+
+// Длина начала заметок (символов), которое списки игр отдают вместо полного текста
+constexpr int NOTES_PREVIEW_LENGTH = 100;
+
 // ============================================================
 // ТАБЛИЦА 1: users - Пользователи системы
 // ============================================================
@@ -74,12 +83,15 @@ struct Game {
     int rating;                 // Оценка: -1 = отсутствует, 0-10 = оценка
     bool is_favorite;           // Избранное
     bool is_installed;          // Установлено
-    std::string notes;          // Заметки пользователя
+    std::string notes;          // Заметки пользователя (списки их не загружают, см. has_notes)
+    bool has_notes;             // Заметки непустые
+    std::string notes_preview;  // Первые NOTES_PREVIEW_LENGTH символов заметок
     std::string tags;           // Теги (строка для отображения, агрегация из game_tags)
     std::vector<int> tag_ids;   // ID тегов (для редактирования)
     
     Game() : id(0), disk_space(0), ram_usage(0), vram_required(0), genre_id(0),
-             completed(false), user_id(0), rating(-1), is_favorite(false), is_installed(false) {}
+             completed(false), user_id(0), rating(-1), is_favorite(false), is_installed(false),
+             has_notes(false) {}
 };
 
 // ============================================================
@@ -139,6 +151,9 @@ struct GameFilter {
     bool filter_has_rating;      // Фильтр: только с оценкой / без оценки
     bool has_rating_value;
     
+    bool filter_name;            // Поиск по подстроке названия (без учёта регистра)
+    std::string name_query;
+    
     GameFilter() : 
         filter_completed(false), completed_value(false),
         filter_genre(false), genre_id(0),
@@ -153,7 +168,8 @@ struct GameFilter {
         filter_installed(false), installed_value(false),
         filter_rating_min(false), rating_min(0),
         filter_rating_max(false), rating_max(10),
-        filter_has_rating(false), has_rating_value(false) {}
+        filter_has_rating(false), has_rating_value(false),
+        filter_name(false) {}
     
     void reset() {
         filter_completed = false;
@@ -172,6 +188,15 @@ struct GameFilter {
         filter_rating_min = false;
         filter_rating_max = false;
         filter_has_rating = false;
+        filter_name = false;
+        name_query.clear();
+    }
+    
+    bool isActive() const {
+        return filter_completed || filter_genre || filter_disk_space_min || filter_disk_space_max ||
+               filter_ram_min || filter_ram_max || filter_vram_min || filter_vram_max ||
+               filter_tag || filter_favorite || filter_installed || filter_rating_min ||
+               filter_rating_max || filter_has_rating || filter_name;
     }
 };
 
@@ -179,7 +204,12 @@ struct GameFilter {
 constexpr uint32_t FILE_MAGIC = 0x54454D50; // "TEMP" в hex
 
 // Версия формата файла (увеличена для новых полей)
-constexpr uint16_t FILE_VERSION = 4;  // v4 для нормализованной БД
+constexpr uint16_t FILE_VERSION = 5;  // v5: секции-футеры после записей (индексы)
+
+// Флаги заголовка файла
+constexpr uint32_t FILE_FLAG_INDEX = 0x1;   // Есть индексные секции (имя/ID -> номер записи)
+constexpr uint32_t FILE_FLAG_DELTA = 0x2;   // Дифференциальный экспорт: записи = изменённые игры
+constexpr uint32_t FILE_FLAG_RECORD_CRC = 0x4;  // Есть секция CRC32C каждой записи
 
 // Заголовок бинарного файла с хешем для проверки целостности
 #pragma pack(push, 1)
@@ -187,15 +217,66 @@ struct BinaryFileHeader {
     uint32_t magic;              // Магическое число для идентификации
     uint16_t version;            // Версия формата
     uint32_t record_count;       // Количество записей
-    char hash[64];               // SHA-256 хеш данных (hex-строка)
-    uint8_t reserved[26];        // Резерв для будущих расширений
+    char hash[64];               // SHA-256 хеш данных (hex-строка): записи + секции футера
+    uint32_t flags;              // FILE_FLAG_* (v5+)
+    uint64_t footer_offset;      // Смещение первой секции футера, 0 = секций нет (v5+)
+    uint8_t reserved[14];        // Резерв для будущих расширений
     
-    BinaryFileHeader() : magic(FILE_MAGIC), version(FILE_VERSION), record_count(0) {
+    BinaryFileHeader() : magic(FILE_MAGIC), version(FILE_VERSION), record_count(0),
+                         flags(0), footer_offset(0) {
         std::memset(hash, 0, sizeof(hash));
         std::memset(reserved, 0, sizeof(reserved));
     }
 };
 #pragma pack(pop)
+static_assert(sizeof(BinaryFileHeader) == 100, "BinaryFileHeader layout must stay compatible with v4");
+
+// Секции футера: [BinarySectionHeader][payload size байт], секции идут подряд до конца файла.
+// Неизвестные секции пропускаются читателем.
+constexpr uint32_t SECTION_NAME_INDEX = 0x5844494E; // "NIDX"
+constexpr uint32_t SECTION_ID_INDEX = 0x58444949;   // "IIDX"
+constexpr uint32_t SECTION_DELTA = 0x41544C44;      // "DLTA"
+constexpr uint32_t SECTION_RECORD_CRC = 0x53435243; // "CRCS": uint32_t CRC32C на запись, по порядку
+
+#pragma pack(push, 1)
+struct BinarySectionHeader {
+    uint32_t tag;                // SECTION_*
+    uint32_t reserved;
+    uint64_t size;               // Размер данных секции (без заголовка)
+    
+    BinarySectionHeader() : tag(0), reserved(0), size(0) {}
+};
+
+// Элемент индекса по имени: отсортирован по (name_hash, record_no)
+struct BinaryNameIndexEntry {
+    uint64_t name_hash;          // FNV-1a 64 от названия игры
+    uint32_t record_no;          // Номер записи в файле
+};
+
+// Элемент индекса по ID: отсортирован по id
+struct BinaryIdIndexEntry {
+    int32_t id;
+    uint32_t record_no;
+};
+
+// Секция дельты: хеш базового файла, затем deleted_count записей BinaryDeltaDeletion
+struct BinaryDeltaInfo {
+    char base_hash[64];          // SHA-256 файла, относительно которого построена дельта
+    uint32_t deleted_count;      // Количество удалённых (или переименованных) игр
+    
+    BinaryDeltaInfo() : deleted_count(0) {
+        std::memset(base_hash, 0, sizeof(base_hash));
+    }
+};
+
+struct BinaryDeltaDeletion {
+    char name[256];              // Название удалённой игры
+    
+    BinaryDeltaDeletion() {
+        std::memset(name, 0, sizeof(name));
+    }
+};
+#pragma pack(pop)
 
 // Структура для бинарного файла (одна запись игры)
 #pragma pack(push, 1)
@@ -0,0 +1,57 @@
+#ifndef USER_LIST_MODEL_H
+#define USER_LIST_MODEL_H
+
+#include <QAbstractTableModel>
+#include <vector>
+
+#include "database_manager.h"
+
+namespace Temporium {
+
+// Модель списка пользователей панели администратора. Страницы по PAGE_SIZE
+// строк запрашивает владелец по сигналу pageRequested (обычно в фоне)
+// и возвращает через appendPage.
+class UserListModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        ColId = 0,
+        ColUsername,
+        ColRole,
+        ColGames,
+        ColumnCount
+    };
+
+    static constexpr int PAGE_SIZE = 200;
+
+    explicit UserListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    // Очистка перед новой выборкой; первая страница запрашивается следующим fetchMore
+    void reset();
+    void appendPage(std::vector<UserSummary> page);
+    // Запрос страницы не выполнен: подгрузку можно повторить, hasMore_ не меняется
+    void pageFailed();
+    void removeUsers(const std::vector<int>& userIds);
+
+    const UserSummary& userAt(int row) const { return users_[static_cast<size_t>(row)]; }
+
+signals:
+    void pageRequested(const UserPageKey& after);
+
+private:
+    std::vector<UserSummary> users_;
+    bool hasMore_ = false;
+    bool loading_ = false;      // Страница запрошена, ответа ещё нет
+};
+
+} // namespace Temporium
+
+#endif // USER_LIST_MODEL_H
@@ -44,6 +44,7 @@ CREATE TABLE IF NOT EXISTS games (
     is_installed BOOLEAN DEFAULT FALSE,
     notes TEXT DEFAULT '',
     created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     UNIQUE(name, user_id)
 );
 
@@ -55,8 +56,67 @@ CREATE TABLE IF NOT EXISTS game_tags (
     UNIQUE(game_id, tag_id)
 );
 
+-- Журнал удалений игр (для дифференциального экспорта)
+CREATE TABLE IF NOT EXISTS game_deletions (
+    id SERIAL PRIMARY KEY,
+    user_id INTEGER REFERENCES users(id) ON DELETE CASCADE,
+    name VARCHAR(255) NOT NULL,
+    deleted_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+);
+
+-- Зарегистрированные экспорты: хеш файла -> отметка снимка (база для дельт).
+-- snapshot_at — начало самой старой транзакции, открытой к снимку: updated_at и
+-- deleted_at ставятся временем начала транзакции писателя
+CREATE TABLE IF NOT EXISTS export_snapshots (
+    hash VARCHAR(64) PRIMARY KEY,
+    user_id INTEGER REFERENCES users(id) ON DELETE CASCADE,
+    snapshot_at TIMESTAMP NOT NULL,
+    base_hash VARCHAR(64)
+);
+
+-- Отслеживание изменений: updated_at и журнал удалений/переименований
+CREATE OR REPLACE FUNCTION games_track_changes() RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        INSERT INTO game_deletions (user_id, name) VALUES (OLD.user_id, OLD.name);
+        RETURN OLD;
+    END IF;
+    IF OLD.name IS DISTINCT FROM NEW.name THEN
+        INSERT INTO game_deletions (user_id, name) VALUES (OLD.user_id, OLD.name);
+    END IF;
+    NEW.updated_at = now();
+    RETURN NEW;
+END $$ LANGUAGE plpgsql;
+
+CREATE OR REPLACE FUNCTION game_tags_touch_game() RETURNS TRIGGER AS $$
+BEGIN
+    UPDATE games SET updated_at = now()
+    WHERE id = CASE WHEN TG_OP = 'DELETE' THEN OLD.game_id ELSE NEW.game_id END
+    AND updated_at IS DISTINCT FROM now();
+    RETURN NULL;
+END $$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_games_update ON games;
+CREATE TRIGGER trg_games_update BEFORE UPDATE ON games
+    FOR EACH ROW EXECUTE FUNCTION games_track_changes();
+DROP TRIGGER IF EXISTS trg_games_delete ON games;
+CREATE TRIGGER trg_games_delete AFTER DELETE ON games
+    FOR EACH ROW EXECUTE FUNCTION games_track_changes();
+DROP TRIGGER IF EXISTS trg_game_tags_touch ON game_tags;
+CREATE TRIGGER trg_game_tags_touch AFTER INSERT OR DELETE ON game_tags
+    FOR EACH ROW EXECUTE FUNCTION game_tags_touch_game();
+
 -- Индексы для оптимизации запросов
 CREATE INDEX IF NOT EXISTS idx_games_user_id ON games(user_id);
+CREATE INDEX IF NOT EXISTS idx_games_user_updated ON games(user_id, updated_at);
+CREATE INDEX IF NOT EXISTS idx_games_user_name ON games(user_id, name, id);
+-- Индексы порядков GameSort (keyset-пагинация по любому столбцу)
+CREATE INDEX IF NOT EXISTS idx_games_user_disk ON games(user_id, disk_space, id);
+CREATE INDEX IF NOT EXISTS idx_games_user_ram ON games(user_id, ram_usage, id);
+CREATE INDEX IF NOT EXISTS idx_games_user_vram ON games(user_id, vram_required, id);
+CREATE INDEX IF NOT EXISTS idx_games_user_genre ON games(user_id, (COALESCE(genre_id, 0)), id);
+CREATE INDEX IF NOT EXISTS idx_games_user_rating ON games(user_id, (COALESCE(rating, -1)), id);
+CREATE INDEX IF NOT EXISTS idx_game_deletions_user ON game_deletions(user_id, deleted_at);
 CREATE INDEX IF NOT EXISTS idx_games_genre_id ON games(genre_id);
 CREATE INDEX IF NOT EXISTS idx_games_completed ON games(completed);
 CREATE INDEX IF NOT EXISTS idx_games_favorite ON games(is_favorite);
@@ -0,0 +1,142 @@
+#include "binary_copy_reader.h"
+#include <libpq-fe.h>
+#include <cstring>
+namespace Temporium {
+// Заголовок двоичного COPY: сигнатура, флаги, длина расширения
+static const char COPY_SIGNATURE[] = "PGCOPY\n\377\r\n";
+static constexpr size_t COPY_SIGNATURE_SIZE = 11;
+static uint32_t readUint32(const char* data) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+static int16_t readInt16(const char* data) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<int16_t>((uint16_t(p[0]) << 8) | uint16_t(p[1]));
+}
+BinaryCopyReader::BinaryCopyReader(const std::string& conn_string) {
+    conn_ = PQconnectdb(conn_string.c_str());
+    if (PQstatus(conn_) != CONNECTION_OK) {
+        fail(PQerrorMessage(conn_));
+    }
+}
+BinaryCopyReader::~BinaryCopyReader() {
+    releaseBuffer();
+    if (conn_) {
+        PQfinish(conn_);
+    }
+}
+bool BinaryCopyReader::isConnected() const {
+    return conn_ && PQstatus(conn_) == CONNECTION_OK;
+}
+bool BinaryCopyReader::fail(const std::string& message) {
+    failed_ = true;
+    error_ = message;
+    return false;
+}
+void BinaryCopyReader::releaseBuffer() {
+    if (buffer_) {
+        PQfreemem(buffer_);
+        buffer_ = nullptr;
+    }
+}
+bool BinaryCopyReader::exec(const std::string& sql) {
+    if (!isConnected()) return fail("Нет подключения к базе данных");
+    PGresult* res = PQexec(conn_, sql.c_str());
+    bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok) fail(PQresultErrorMessage(res));
+    PQclear(res);
+    return ok;
+}
+bool BinaryCopyReader::start(const std::string& select_sql) {
+    if (!isConnected()) return fail("Нет подключения к базе данных");
+    std::string sql = "COPY (" + select_sql + ") TO STDOUT (FORMAT binary)";
+    PGresult* res = PQexec(conn_, sql.c_str());
+    bool ok = PQresultStatus(res) == PGRES_COPY_OUT;
+    if (!ok) fail(PQresultErrorMessage(res));
+    PQclear(res);
+    headerRead_ = false;
+    copying_ = ok;
+    return ok;
+}
+bool BinaryCopyReader::next() {
+    releaseBuffer();
+    fields_.clear();
+    if (!copying_) return false;
+    // Синхронный режим: одно сообщение CopyData на вызов, в нём ровно один кортеж
+    // (заголовок приходит вместе с первым кортежем, признак конца — отдельно)
+    int size = PQgetCopyData(conn_, &buffer_, 0);
+    if (size >= 0 && parseTuple(buffer_, static_cast<size_t>(size))) return true;
+    // Признак конца данных или ошибка разбора: поток всё равно дочитывается до -1.
+    // Пока libpq в состоянии COPY OUT, PQgetResult возвращает PGRES_COPY_OUT бесконечно
+    while (size >= 0) {
+        releaseBuffer();
+        size = PQgetCopyData(conn_, &buffer_, 0);
+    }
+    if (size == -2) {
+        fail(PQerrorMessage(conn_));
+    }
+    copying_ = false;
+    releaseBuffer();
+    fields_.clear();
+    // Итог команды COPY
+    while (PGresult* res = PQgetResult(conn_)) {
+        if (PQresultStatus(res) != PGRES_COMMAND_OK && !failed_) {
+            fail(PQresultErrorMessage(res));
+        }
+        PQclear(res);
+    }
+    return false;
+}
+bool BinaryCopyReader::parseTuple(const char* data, size_t size) {
+    size_t pos = 0;
+    if (!headerRead_) {
+        if (size < COPY_SIGNATURE_SIZE + 8 || std::memcmp(data, COPY_SIGNATURE, COPY_SIGNATURE_SIZE) != 0) {
+            return fail("Неверный заголовок двоичного COPY");
+        }
+        pos = COPY_SIGNATURE_SIZE + 4;  // Флаги не используются
+        uint32_t extension = readUint32(data + pos);
+        pos += 4;
+        if (extension > size - pos) return fail("Неверный заголовок двоичного COPY");
+        pos += extension;
+        headerRead_ = true;
+    }
+    if (size - pos < 2) return fail("Обрезанный кортеж двоичного COPY");
+    int16_t count = readInt16(data + pos);
+    pos += 2;
+    if (count < 0) return false;    // Признак конца данных
+    fields_.reserve(static_cast<size_t>(count));
+    for (int16_t i = 0; i < count; ++i) {
+        if (size - pos < 4) return fail("Обрезанный кортеж двоичного COPY");
+        int32_t length = static_cast<int32_t>(readUint32(data + pos));
+        pos += 4;
+        if (length < 0) {
+            fields_.push_back(Field{nullptr, -1});
+            continue;
+        }
+        if (static_cast<size_t>(length) > size - pos) return fail("Обрезанный кортеж двоичного COPY");
+        fields_.push_back(Field{data + pos, length});
+        pos += static_cast<size_t>(length);
+    }
+    return true;
+}
+std::string_view BinaryCopyReader::text(size_t i) const {
+    const Field& field = fields_[i];
+    return field.size < 0 ? std::string_view() : std::string_view(field.data, static_cast<size_t>(field.size));
+}
+int32_t BinaryCopyReader::int4(size_t i) const {
+    const Field& field = fields_[i];
+    return field.size == 4 ? static_cast<int32_t>(readUint32(field.data)) : 0;
+}
+double BinaryCopyReader::float8(size_t i) const {
+    const Field& field = fields_[i];
+    if (field.size != 8) return 0;
+    uint64_t bits = (uint64_t(readUint32(field.data)) << 32) | readUint32(field.data + 4);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+bool BinaryCopyReader::boolean(size_t i) const {
+    const Field& field = fields_[i];
+    return field.size == 1 && field.data[0] != 0;
+}
+} // namespace Temporium
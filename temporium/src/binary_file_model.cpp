@@ -0,0 +1,151 @@
+#include "binary_file_model.h"
+#include <QColor>
+#include <QStringList>
+#include <algorithm>
+#include <cstring>
+namespace Temporium {
+static const QColor DAMAGED_ROW_COLOR(90, 30, 30, 200);
+static QString recordText(const char* data, size_t capacity) {
+    return QString::fromUtf8(data, static_cast<int>(strnlen(data, capacity)));
+}
+BinaryFileModel::BinaryFileModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+bool BinaryFileModel::open(const QString& filename) {
+    beginResetModel();
+    cache_.clear();
+    cacheIndex_.clear();
+    damaged_.clear();
+    records_ = nullptr;
+    recordCount_ = 0;
+    file_.close();
+    file_.setFileName(filename);
+    bool opened = false;
+    if (!file_.open(QIODevice::ReadOnly)) {
+        error_ = file_.errorString();
+    } else if (file_.size() < static_cast<qint64>(sizeof(BinaryFileHeader))) {
+        error_ = "Файл слишком мал для заголовка";
+    } else if (const uchar* data = file_.map(0, file_.size())) {
+        BinaryFileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic != FILE_MAGIC) {
+            error_ = "Неверный формат файла";
+        } else if (header.version > FILE_VERSION) {
+            error_ = "Неподдерживаемая версия файла";
+        } else {
+            // Обрезанный файл: показываются только записи, целиком попавшие в отображение
+            qint64 available = (file_.size() - static_cast<qint64>(sizeof(header))) /
+                               static_cast<qint64>(sizeof(BinaryGameRecord));
+            records_ = data + sizeof(header);
+            recordCount_ = static_cast<int>(std::min<qint64>(header.record_count, available));
+            opened = true;
+        }
+    } else {
+        error_ = file_.errorString();
+    }
+    if (!opened) {
+        file_.close();
+    }
+    endResetModel();
+    return opened;
+}
+int BinaryFileModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : recordCount_;
+}
+int BinaryFileModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+const BinaryGameRecord* BinaryFileModel::recordAt(int row) const {
+    // Записи упакованы (#pragma pack 1), выравнивание указателя не требуется
+    return reinterpret_cast<const BinaryGameRecord*>(records_ + static_cast<size_t>(row) * sizeof(BinaryGameRecord));
+}
+const BinaryFileModel::Row& BinaryFileModel::rowAt(int row) const {
+    auto cached = cacheIndex_.find(row);
+    if (cached != cacheIndex_.end()) {
+        cache_.splice(cache_.begin(), cache_, cached->second);
+        return cached->second->second;
+    }
+    const BinaryGameRecord* record = recordAt(row);
+    Row decoded;
+    decoded.name = recordText(record->name, sizeof(record->name));
+    decoded.genre = recordText(record->genre, sizeof(record->genre));
+    decoded.url = recordText(record->url, sizeof(record->url));
+    decoded.disk_space = record->disk_space;
+    decoded.ram_usage = record->ram_usage;
+    decoded.vram_required = record->vram_required;
+    decoded.completed = record->completed != 0;
+    cache_.emplace_front(row, std::move(decoded));
+    cacheIndex_[row] = cache_.begin();
+    if (cache_.size() > CACHE_SIZE) {
+        cacheIndex_.erase(cache_.back().first);
+        cache_.pop_back();
+    }
+    return cache_.front().second;
+}
+QVariant BinaryFileModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= recordCount_) {
+        return QVariant();
+    }
+    const int row = index.row();
+    bool damaged = static_cast<size_t>(row) < damaged_.size() && damaged_[static_cast<size_t>(row)];
+    switch (role) {
+    case Qt::DisplayRole: {
+        const Row& game = rowAt(row);
+        switch (index.column()) {
+        case ColName:      return game.name;
+        case ColDisk:      return QString::number(game.disk_space, 'f', 1);
+        case ColRam:       return QString::number(game.ram_usage, 'f', 1);
+        case ColVram:      return QString::number(game.vram_required, 'f', 1);
+        case ColGenre:     return game.genre;
+        case ColCompleted: return game.completed ? QStringLiteral("Да") : QStringLiteral("Нет");
+        case ColUrl:       return game.url;
+        }
+        break;
+    }
+    case Qt::BackgroundRole:
+        if (damaged) return DAMAGED_ROW_COLOR;
+        break;
+    case Qt::ToolTipRole:
+        if (damaged) return QStringLiteral("Запись повреждена: контрольная сумма не совпадает");
+        break;
+    }
+    return QVariant();
+}
+QVariant BinaryFileModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+    static const QStringList headers = {
+        "Название", "Диск (ГБ)", "ОЗУ (ГБ)", "VRAM (ГБ)", "Жанр", "Пройдено", "Ссылка"
+    };
+    return section >= 0 && section < headers.size() ? headers[section] : QVariant();
+}
+int BinaryFileModel::findName(const QString& text, int from) const {
+    if (text.isEmpty() || recordCount_ == 0) return -1;
+    from = std::max(0, std::min(from, recordCount_ - 1));
+    for (int step = 0; step < recordCount_; ++step) {
+        int row = (from + step) % recordCount_;
+        const BinaryGameRecord* record = recordAt(row);
+        if (recordText(record->name, sizeof(record->name)).contains(text, Qt::CaseInsensitive)) {
+            return row;
+        }
+    }
+    return -1;
+}
+void BinaryFileModel::setDamagedRecords(const std::vector<uint32_t>& damaged) {
+    damaged_.assign(static_cast<size_t>(recordCount_), false);
+    for (uint32_t record_no : damaged) {
+        if (record_no < damaged_.size()) {
+            damaged_[record_no] = true;
+        }
+    }
+    if (recordCount_ > 0) {
+        emit dataChanged(index(0, 0), index(recordCount_ - 1, ColumnCount - 1),
+                         {Qt::BackgroundRole, Qt::ToolTipRole});
+    }
+}
+} // namespace Temporium
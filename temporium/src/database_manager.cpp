@@ -1,11 +1,19 @@
 #include "database_manager.h"
 #include "hash_utils.h"
+#include "binary_copy_reader.h"
+#include <libpq-fe.h>
 #include <fstream>
 #include <cstring>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <set>
+#include <climits>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <cstdio>
+#include <string_view>
+#include <charconv>
 namespace Temporium {
 DatabaseManager::DatabaseManager() : conn_(nullptr) {}
 DatabaseManager::~DatabaseManager() {
@@ -22,7 +30,8 @@ bool DatabaseManager::connect(const std::string& host, int port,
                  << " dbname=" << dbname 
                  << " user=" << user 
                  << " password=" << password;
-        conn_ = std::make_unique<pqxx::connection>(conn_str.str());
+        conn_string_ = conn_str.str();
+        conn_ = std::make_unique<pqxx::connection>(conn_string_);
         if (conn_->is_open()) {
             if (initializeTables()) {
                 ensureAdminExists();
@@ -37,7 +46,30 @@ bool DatabaseManager::connect(const std::string& host, int port,
         return false;
     }
 }
+bool DatabaseManager::connectSecondary(const DatabaseManager& primary) {
+    try {
+        conn_string_ = primary.conn_string_;
+        conn_ = std::make_unique<pqxx::connection>(conn_string_);
+        if (conn_->is_open()) {
+            return true;
+        }
+        last_error_ = "Failed to open database connection";
+        return false;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Connection error: ") + e.what();
+        return false;
+    }
+}
+void DatabaseManager::cancelQuery() {
+    try {
+        if (conn_) {
+            conn_->cancel_query();
+        }
+    } catch (const std::exception& e) {
+    }
+}
 void DatabaseManager::disconnect() {
+    closePipelineConnection();
     if (conn_) {
         conn_.reset();
     }
@@ -45,10 +77,89 @@ void DatabaseManager::disconnect() {
 bool DatabaseManager::isConnected() const {
     return conn_ && conn_->is_open();
 }
+DatabaseManager::Work::Work(DatabaseManager& db) : db_(db) {
+    if (db_.batch_depth_ == 0) {
+        own_.emplace(*db_.conn_);
+        txn_ = &*own_;
+    } else if (db_.batch_work_ && !db_.batch_failed_) {
+        txn_ = db_.batch_work_.get();
+    } else {
+        // Единица уже не может быть зафиксирована: шаг не выполняется
+        db_.batch_failed_ = true;
+        throw std::runtime_error("unit of work is not active");
+    }
+}
+DatabaseManager::Work::~Work() {
+    if (!own_ && !committed_) {
+        db_.batch_failed_ = true;
+    }
+}
+void DatabaseManager::Work::commit() {
+    if (own_) {
+        own_->commit();
+        ++db_.commit_count_;
+    }
+    committed_ = true;
+}
+void DatabaseManager::Work::afterCommit(std::function<void()> action) {
+    if (own_) {
+        action();
+    } else {
+        db_.batch_after_commit_.push_back(std::move(action));
+    }
+}
+DatabaseManager::UnitOfWork::UnitOfWork(DatabaseManager& db) : db_(db) {
+    if (db_.batch_depth_++ > 0) return;
+    owner_ = true;
+    db_.batch_failed_ = false;
+    try {
+        db_.batch_work_ = std::make_unique<pqxx::work>(*db_.conn_);
+    } catch (const std::exception& e) {
+        db_.last_error_ = std::string("Begin transaction error: ") + e.what();
+        db_.batch_failed_ = true;
+    }
+}
+DatabaseManager::UnitOfWork::~UnitOfWork() {
+    if (!finished_ && !owner_) {
+        // Вложенная единица без commit() отменяет и внешнюю
+        db_.batch_failed_ = true;
+    }
+    finish();
+}
+void DatabaseManager::UnitOfWork::finish() {
+    if (finished_) return;
+    finished_ = true;
+    --db_.batch_depth_;
+    if (owner_) {
+        // Незафиксированная pqxx::work откатывается в деструкторе, отложенные действия — вместе с ней
+        db_.batch_work_.reset();
+        db_.batch_after_commit_.clear();
+    }
+}
+bool DatabaseManager::UnitOfWork::commit() {
+    if (finished_) return false;
+    bool ok = !db_.batch_failed_;
+    if (owner_ && ok) {
+        try {
+            db_.batch_work_->commit();
+            ++db_.commit_count_;
+        } catch (const std::exception& e) {
+            db_.last_error_ = std::string("Commit error: ") + e.what();
+            ok = false;
+        }
+        if (ok) {
+            for (const auto& action : db_.batch_after_commit_) {
+                action();
+            }
+        }
+    }
+    finish();
+    return ok;
+}
 bool DatabaseManager::initializeTables() {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec(
+        Work txn(*this);
+        txn->exec(
             "CREATE TABLE IF NOT EXISTS users ("
             "    id SERIAL PRIMARY KEY,"
             "    username VARCHAR(255) UNIQUE NOT NULL,"
@@ -57,14 +168,14 @@ bool DatabaseManager::initializeTables() {
             "    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
             ")"
         );
-        txn.exec(
+        txn->exec(
             "CREATE TABLE IF NOT EXISTS genres ("
             "    id SERIAL PRIMARY KEY,"
             "    name VARCHAR(64) UNIQUE NOT NULL,"
             "    description TEXT DEFAULT ''"
             ")"
         );
-        txn.exec(
+        txn->exec(
             "CREATE TABLE IF NOT EXISTS tags ("
             "    id SERIAL PRIMARY KEY,"
             "    name VARCHAR(64) NOT NULL,"
@@ -73,7 +184,7 @@ bool DatabaseManager::initializeTables() {
             "    UNIQUE(name, user_id)"
             ")"
         );
-        txn.exec(
+        txn->exec(
             "CREATE TABLE IF NOT EXISTS games ("
             "    id SERIAL PRIMARY KEY,"
             "    name VARCHAR(255) NOT NULL,"
@@ -92,7 +203,7 @@ bool DatabaseManager::initializeTables() {
             "    UNIQUE(name, user_id)"
             ")"
         );
-        txn.exec(
+        txn->exec(
             "CREATE TABLE IF NOT EXISTS game_tags ("
             "    id SERIAL PRIMARY KEY,"
             "    game_id INTEGER REFERENCES games(id) ON DELETE CASCADE,"
@@ -100,25 +211,81 @@ bool DatabaseManager::initializeTables() {
             "    UNIQUE(game_id, tag_id)"
             ")"
         );
-        txn.exec(
+        txn->exec(
             "DO $$ BEGIN "
             "    ALTER TABLE users ADD COLUMN IF NOT EXISTS is_admin BOOLEAN DEFAULT FALSE; "
             "EXCEPTION WHEN others THEN NULL; END $$"
         );
-        txn.exec(
+        txn->exec(
             "DO $$ BEGIN "
             "    ALTER TABLE games ADD COLUMN IF NOT EXISTS genre_id INTEGER REFERENCES genres(id) ON DELETE SET NULL; "
             "EXCEPTION WHEN others THEN NULL; END $$"
         );
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_games_user_id ON games(user_id)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_games_genre_id ON games(genre_id)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_games_completed ON games(completed)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_games_favorite ON games(is_favorite)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_games_rating ON games(rating)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_games_installed ON games(is_installed)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_tags_user_id ON tags(user_id)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_game_tags_game_id ON game_tags(game_id)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_game_tags_tag_id ON game_tags(tag_id)");
+        txn->exec("ALTER TABLE games ADD COLUMN IF NOT EXISTS updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP");
+        txn->exec(
+            "CREATE TABLE IF NOT EXISTS game_deletions ("
+            "    id SERIAL PRIMARY KEY,"
+            "    user_id INTEGER REFERENCES users(id) ON DELETE CASCADE,"
+            "    name VARCHAR(255) NOT NULL,"
+            "    deleted_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
+            ")"
+        );
+        txn->exec(
+            "CREATE TABLE IF NOT EXISTS export_snapshots ("
+            "    hash VARCHAR(64) PRIMARY KEY,"
+            "    user_id INTEGER REFERENCES users(id) ON DELETE CASCADE,"
+            "    snapshot_at TIMESTAMP NOT NULL,"
+            "    base_hash VARCHAR(64)"
+            ")"
+        );
+        txn->exec(
+            "CREATE OR REPLACE FUNCTION games_track_changes() RETURNS TRIGGER AS $$ BEGIN "
+            "    IF TG_OP = 'DELETE' THEN "
+            "        INSERT INTO game_deletions (user_id, name) VALUES (OLD.user_id, OLD.name); "
+            "        RETURN OLD; "
+            "    END IF; "
+            "    IF OLD.name IS DISTINCT FROM NEW.name THEN "
+            "        INSERT INTO game_deletions (user_id, name) VALUES (OLD.user_id, OLD.name); "
+            "    END IF; "
+            "    NEW.updated_at = now(); "
+            "    RETURN NEW; "
+            "END $$ LANGUAGE plpgsql"
+        );
+        txn->exec(
+            "CREATE OR REPLACE FUNCTION game_tags_touch_game() RETURNS TRIGGER AS $$ BEGIN "
+            "    UPDATE games SET updated_at = now() "
+            "    WHERE id = CASE WHEN TG_OP = 'DELETE' THEN OLD.game_id ELSE NEW.game_id END "
+            "    AND updated_at IS DISTINCT FROM now(); "
+            "    RETURN NULL; "
+            "END $$ LANGUAGE plpgsql"
+        );
+        txn->exec("DROP TRIGGER IF EXISTS trg_games_update ON games");
+        txn->exec("CREATE TRIGGER trg_games_update BEFORE UPDATE ON games "
+                 "FOR EACH ROW EXECUTE FUNCTION games_track_changes()");
+        txn->exec("DROP TRIGGER IF EXISTS trg_games_delete ON games");
+        txn->exec("CREATE TRIGGER trg_games_delete AFTER DELETE ON games "
+                 "FOR EACH ROW EXECUTE FUNCTION games_track_changes()");
+        txn->exec("DROP TRIGGER IF EXISTS trg_game_tags_touch ON game_tags");
+        txn->exec("CREATE TRIGGER trg_game_tags_touch AFTER INSERT OR DELETE ON game_tags "
+                 "FOR EACH ROW EXECUTE FUNCTION game_tags_touch_game()");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_user_id ON games(user_id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_user_updated ON games(user_id, updated_at)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_user_name ON games(user_id, name, id)");
+        // Индексы порядков GameSort: выражения совпадают с sortExpression()
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_user_disk ON games(user_id, disk_space, id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_user_ram ON games(user_id, ram_usage, id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_user_vram ON games(user_id, vram_required, id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_user_genre ON games(user_id, (COALESCE(genre_id, 0)), id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_user_rating ON games(user_id, (COALESCE(rating, -1)), id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_game_deletions_user ON game_deletions(user_id, deleted_at)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_genre_id ON games(genre_id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_completed ON games(completed)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_favorite ON games(is_favorite)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_rating ON games(rating)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_games_installed ON games(is_installed)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_tags_user_id ON tags(user_id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_game_tags_game_id ON game_tags(game_id)");
+        txn->exec("CREATE INDEX IF NOT EXISTS idx_game_tags_tag_id ON game_tags(tag_id)");
         txn.commit();
         return true;
     } catch (const std::exception& e) {
@@ -128,11 +295,11 @@ bool DatabaseManager::initializeTables() {
 }
 void DatabaseManager::ensureAdminExists() {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec("SELECT COUNT(*) FROM users WHERE is_admin = TRUE");
+        Work txn(*this);
+        pqxx::result r = txn->exec("SELECT COUNT(*) FROM users WHERE is_admin = TRUE");
         if (r[0][0].as<int>() == 0) {
             std::string adminHash = HashUtils::hashPassword("admin123", "admin");
-            txn.exec_params(
+            txn->exec_params(
                 "INSERT INTO users (username, password_hash, is_admin) VALUES ($1, $2, TRUE)",
                 "admin", adminHash
             );
@@ -143,11 +310,11 @@ void DatabaseManager::ensureAdminExists() {
 }
 void DatabaseManager::ensureDefaultGenres() {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec("SELECT COUNT(*) FROM genres");
+        Work txn(*this);
+        pqxx::result r = txn->exec("SELECT COUNT(*) FROM genres");
         if (r[0][0].as<int>() == 0) {
             for (const auto& genre : DEFAULT_GENRES) {
-                txn.exec_params(
+                txn->exec_params(
                     "INSERT INTO genres (name, description) VALUES ($1, $2) ON CONFLICT (name) DO NOTHING",
                     genre.first, genre.second
                 );
@@ -159,8 +326,8 @@ void DatabaseManager::ensureDefaultGenres() {
 }
 bool DatabaseManager::registerUser(const std::string& username, const std::string& password_hash, bool is_admin) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params(
+        Work txn(*this);
+        txn->exec_params(
             "INSERT INTO users (username, password_hash, is_admin) VALUES ($1, $2, $3)",
             username, password_hash, is_admin
         );
@@ -174,8 +341,8 @@ bool DatabaseManager::registerUser(const std::string& username, const std::strin
 User DatabaseManager::authenticateUser(const std::string& username, const std::string& password_hash) {
     User user;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT id, username, password_hash, is_admin FROM users WHERE username = $1 AND password_hash = $2",
             username, password_hash
         );
@@ -193,8 +360,8 @@ User DatabaseManager::authenticateUser(const std::string& username, const std::s
 }
 bool DatabaseManager::userExists(const std::string& username) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT COUNT(*) FROM users WHERE username = $1",
             username
         );
@@ -208,8 +375,8 @@ bool DatabaseManager::userExists(const std::string& username) {
 std::vector<User> DatabaseManager::getAllUsers() {
     std::vector<User> users;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec(
+        Work txn(*this);
+        pqxx::result r = txn->exec(
             "SELECT id, username, password_hash, is_admin FROM users ORDER BY username"
         );
         for (const auto& row : r) {
@@ -228,8 +395,8 @@ std::vector<User> DatabaseManager::getAllUsers() {
 }
 bool DatabaseManager::deleteUser(int user_id) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params("DELETE FROM users WHERE id = $1 AND is_admin = FALSE", user_id);
+        Work txn(*this);
+        txn->exec_params("DELETE FROM users WHERE id = $1 AND is_admin = FALSE", user_id);
         txn.commit();
         return true;
     } catch (const std::exception& e) {
@@ -239,8 +406,8 @@ bool DatabaseManager::deleteUser(int user_id) {
 }
 bool DatabaseManager::isAdmin(int user_id) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT is_admin FROM users WHERE id = $1",
             user_id
         );
@@ -250,10 +417,85 @@ bool DatabaseManager::isAdmin(int user_id) {
         return false;
     }
 }
+std::string DatabaseManager::getUsername(int user_id) {
+    try {
+        Work txn(*this);
+        pqxx::result r = txn->exec_params("SELECT username FROM users WHERE id = $1", user_id);
+        txn.commit();
+        return r.empty() ? std::string() : r[0][0].as<std::string>();
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Get username error: ") + e.what();
+        return std::string();
+    }
+}
+// Подстрока для ILIKE: спецсимволы шаблона экранируются
+static std::string likeContainsPattern(const std::string& text) {
+    std::string pattern = "%";
+    for (char c : text) {
+        if (c == '%' || c == '_' || c == '\\') {
+            pattern += '\\';
+        }
+        pattern += c;
+    }
+    return pattern + "%";
+}
+std::vector<UserSummary> DatabaseManager::getUserSummariesPage(const std::string& search, const UserPageKey& after,
+                                                               int limit, bool* ok) {
+    std::vector<UserSummary> users;
+    if (ok) *ok = false;
+    try {
+        Work txn(*this);
+        std::string condition = "TRUE";
+        if (!search.empty()) {
+            condition += " AND u.username ILIKE " + txn->quote(likeContainsPattern(search));
+        }
+        if (after.valid) {
+            condition += " AND u.username > " + txn->quote(after.username);
+        }
+        // Число игр — подзапросом по idx_games_user_name только для строк страницы
+        pqxx::result r = txn->exec(
+            "SELECT u.id, u.username, u.is_admin, "
+            "(SELECT COUNT(*) FROM games g WHERE g.user_id = u.id) AS games_count "
+            "FROM users u "
+            "WHERE " + condition + " "
+            "ORDER BY u.username "
+            "LIMIT " + std::to_string(limit)
+        );
+        users.reserve(r.size());
+        for (const auto& row : r) {
+            UserSummary user;
+            user.id = row["id"].as<int>();
+            user.username = row["username"].as<std::string>();
+            user.is_admin = row["is_admin"].as<bool>();
+            user.games_count = row["games_count"].as<int>();
+            users.push_back(std::move(user));
+        }
+        txn.commit();
+        if (ok) *ok = true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Get users page error: ") + e.what();
+    }
+    return users;
+}
+int DatabaseManager::deleteUsers(const std::vector<int>& user_ids) {
+    if (user_ids.empty()) return 0;
+    try {
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
+            "DELETE FROM users WHERE id = ANY($1) AND is_admin = FALSE",
+            user_ids
+        );
+        txn.commit();
+        return static_cast<int>(r.affected_rows());
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Delete users error: ") + e.what();
+        return -1;
+    }
+}
 int DatabaseManager::getUserGamesCount(int user_id) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT COUNT(*) FROM games WHERE user_id = $1",
             user_id
         );
@@ -265,8 +507,8 @@ int DatabaseManager::getUserGamesCount(int user_id) {
 }
 bool DatabaseManager::changeUsername(int user_id, const std::string& new_username, const std::string& current_password) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT password_hash FROM users WHERE id = $1",
             user_id
         );
@@ -274,7 +516,7 @@ bool DatabaseManager::changeUsername(int user_id, const std::string& new_usernam
             last_error_ = "Invalid current password";
             return false;
         }
-        txn.exec_params(
+        txn->exec_params(
             "UPDATE users SET username = $1 WHERE id = $2",
             new_username, user_id
         );
@@ -287,8 +529,8 @@ bool DatabaseManager::changeUsername(int user_id, const std::string& new_usernam
 }
 bool DatabaseManager::changePassword(int user_id, const std::string& new_password_hash) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params(
+        Work txn(*this);
+        txn->exec_params(
             "UPDATE users SET password_hash = $1 WHERE id = $2",
             new_password_hash, user_id
         );
@@ -301,9 +543,9 @@ bool DatabaseManager::changePassword(int user_id, const std::string& new_passwor
 }
 bool DatabaseManager::resetAdminCredentials() {
     try {
-        pqxx::work txn(*conn_);
+        Work txn(*this);
         std::string newHash = HashUtils::hashPassword("admin123", "admin");
-        txn.exec_params(
+        txn->exec_params(
             "UPDATE users SET username = 'admin', password_hash = $1 WHERE is_admin = TRUE",
             newHash
         );
@@ -314,11 +556,13 @@ bool DatabaseManager::resetAdminCredentials() {
         return false;
     }
 }
-std::vector<Genre> DatabaseManager::getAllGenres() {
+static const char GENRES_SELECT[] = "SELECT id, name, description FROM genres ORDER BY name";
+std::vector<Genre> DatabaseManager::getAllGenres(bool* ok) {
     std::vector<Genre> genres;
+    if (ok) *ok = false;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec("SELECT id, name, description FROM genres ORDER BY name");
+        Work txn(*this);
+        pqxx::result r = txn->exec(GENRES_SELECT);
         for (const auto& row : r) {
             Genre genre;
             genre.id = row["id"].as<int>();
@@ -327,6 +571,7 @@ std::vector<Genre> DatabaseManager::getAllGenres() {
             genres.push_back(genre);
         }
         txn.commit();
+        if (ok) *ok = true;
     } catch (const std::exception& e) {
         last_error_ = std::string("Get genres error: ") + e.what();
     }
@@ -335,8 +580,8 @@ std::vector<Genre> DatabaseManager::getAllGenres() {
 Genre DatabaseManager::getGenreById(int genre_id) {
     Genre genre;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT id, name, description FROM genres WHERE id = $1",
             genre_id
         );
@@ -354,8 +599,8 @@ Genre DatabaseManager::getGenreById(int genre_id) {
 Genre DatabaseManager::getGenreByName(const std::string& name) {
     Genre genre;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT id, name, description FROM genres WHERE name = $1",
             name
         );
@@ -372,8 +617,8 @@ Genre DatabaseManager::getGenreByName(const std::string& name) {
 }
 int DatabaseManager::addGenre(const std::string& name, const std::string& description) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "INSERT INTO genres (name, description) VALUES ($1, $2) RETURNING id",
             name, description
         );
@@ -386,8 +631,8 @@ int DatabaseManager::addGenre(const std::string& name, const std::string& descri
 }
 bool DatabaseManager::updateGenre(int genre_id, const std::string& name, const std::string& description) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params(
+        Work txn(*this);
+        txn->exec_params(
             "UPDATE genres SET name = $1, description = $2 WHERE id = $3",
             name, description, genre_id
         );
@@ -400,8 +645,8 @@ bool DatabaseManager::updateGenre(int genre_id, const std::string& name, const s
 }
 bool DatabaseManager::deleteGenre(int genre_id) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params("DELETE FROM genres WHERE id = $1", genre_id);
+        Work txn(*this);
+        txn->exec_params("DELETE FROM genres WHERE id = $1", genre_id);
         txn.commit();
         return true;
     } catch (const std::exception& e) {
@@ -409,14 +654,13 @@ bool DatabaseManager::deleteGenre(int genre_id) {
         return false;
     }
 }
-std::vector<Tag> DatabaseManager::getUserTags(int user_id) {
+static const char USER_TAGS_SELECT[] = "SELECT id, name, user_id, color FROM tags WHERE user_id = $1 ORDER BY name";
+std::vector<Tag> DatabaseManager::getUserTags(int user_id, bool* ok) {
     std::vector<Tag> tags;
+    if (ok) *ok = false;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
-            "SELECT id, name, user_id, color FROM tags WHERE user_id = $1 ORDER BY name",
-            user_id
-        );
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(USER_TAGS_SELECT, user_id);
         for (const auto& row : r) {
             Tag tag;
             tag.id = row["id"].as<int>();
@@ -426,6 +670,7 @@ std::vector<Tag> DatabaseManager::getUserTags(int user_id) {
             tags.push_back(tag);
         }
         txn.commit();
+        if (ok) *ok = true;
     } catch (const std::exception& e) {
         last_error_ = std::string("Get user tags error: ") + e.what();
     }
@@ -434,8 +679,8 @@ std::vector<Tag> DatabaseManager::getUserTags(int user_id) {
 Tag DatabaseManager::getTagById(int tag_id) {
     Tag tag;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT id, name, user_id, color FROM tags WHERE id = $1",
             tag_id
         );
@@ -454,8 +699,8 @@ Tag DatabaseManager::getTagById(int tag_id) {
 Tag DatabaseManager::getTagByName(const std::string& name, int user_id) {
     Tag tag;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT id, name, user_id, color FROM tags WHERE name = $1 AND user_id = $2",
             name, user_id
         );
@@ -473,8 +718,8 @@ Tag DatabaseManager::getTagByName(const std::string& name, int user_id) {
 }
 int DatabaseManager::addTag(const std::string& name, int user_id, const std::string& color) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "INSERT INTO tags (name, user_id, color) VALUES ($1, $2, $3) RETURNING id",
             name, user_id, color
         );
@@ -487,8 +732,8 @@ int DatabaseManager::addTag(const std::string& name, int user_id, const std::str
 }
 bool DatabaseManager::updateTag(int tag_id, const std::string& name, const std::string& color) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params(
+        Work txn(*this);
+        txn->exec_params(
             "UPDATE tags SET name = $1, color = $2 WHERE id = $3",
             name, color, tag_id
         );
@@ -501,8 +746,8 @@ bool DatabaseManager::updateTag(int tag_id, const std::string& name, const std::
 }
 bool DatabaseManager::deleteTag(int tag_id) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params("DELETE FROM tags WHERE id = $1", tag_id);
+        Work txn(*this);
+        txn->exec_params("DELETE FROM tags WHERE id = $1", tag_id);
         txn.commit();
         return true;
     } catch (const std::exception& e) {
@@ -512,10 +757,10 @@ bool DatabaseManager::deleteTag(int tag_id) {
 }
 bool DatabaseManager::setGameTags(int game_id, const std::vector<int>& tag_ids) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params("DELETE FROM game_tags WHERE game_id = $1", game_id);
+        Work txn(*this);
+        txn->exec_params("DELETE FROM game_tags WHERE game_id = $1", game_id);
         for (int tag_id : tag_ids) {
-            txn.exec_params(
+            txn->exec_params(
                 "INSERT INTO game_tags (game_id, tag_id) VALUES ($1, $2) ON CONFLICT DO NOTHING",
                 game_id, tag_id
             );
@@ -530,8 +775,8 @@ bool DatabaseManager::setGameTags(int game_id, const std::vector<int>& tag_ids)
 std::vector<int> DatabaseManager::getGameTagIds(int game_id) {
     std::vector<int> tag_ids;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT tag_id FROM game_tags WHERE game_id = $1",
             game_id
         );
@@ -547,8 +792,8 @@ std::vector<int> DatabaseManager::getGameTagIds(int game_id) {
 std::vector<Tag> DatabaseManager::getGameTags(int game_id) {
     std::vector<Tag> tags;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT t.id, t.name, t.user_id, t.color "
             "FROM tags t "
             "INNER JOIN game_tags gt ON t.id = gt.tag_id "
@@ -572,8 +817,8 @@ std::vector<Tag> DatabaseManager::getGameTags(int game_id) {
 }
 std::string DatabaseManager::aggregateGameTags(int game_id) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT STRING_AGG(t.name, ', ' ORDER BY t.name) as tags "
             "FROM tags t "
             "INNER JOIN game_tags gt ON t.id = gt.tag_id "
@@ -588,12 +833,97 @@ std::string DatabaseManager::aggregateGameTags(int game_id) {
     }
     return "";
 }
-bool DatabaseManager::addGame(const Game& game) {
+// Списки получают вместо полного текста заметок флаг и начало длиной
+// NOTES_PREVIEW_LENGTH символов; целиком заметки читает getGameNotes
+static const std::string NOTES_SUMMARY_COLUMNS =
+    "COALESCE(g.notes, '') <> '' AS has_notes, "
+    "LEFT(g.notes, " + std::to_string(NOTES_PREVIEW_LENGTH) + ") AS notes_preview ";
+static void readNotesSummary(const pqxx::row& row, Game& game) {
+    game.has_notes = row["has_notes"].as<bool>();
+    game.notes_preview = row["notes_preview"].is_null() ? "" : row["notes_preview"].as<std::string>();
+}
+// Строка игры с названием жанра и тегами, агрегированными одним LATERAL-подзапросом
+static const std::string GAME_ROW_SELECT =
+    "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
+    "g.genre_id, COALESCE(gen.name, 'Unknown') as genre, g.completed, g.url, "
+    "g.user_id, g.rating, g.is_favorite, g.is_installed, " + NOTES_SUMMARY_COLUMNS + ", "
+    "COALESCE(gt.tags, '') as tags "
+    "FROM games g "
+    "LEFT JOIN genres gen ON g.genre_id = gen.id "
+    "LEFT JOIN LATERAL ("
+    "    SELECT STRING_AGG(t.name, ', ' ORDER BY t.name) AS tags "
+    "    FROM game_tags gt2 INNER JOIN tags t ON t.id = gt2.tag_id "
+    "    WHERE gt2.game_id = g.id"
+    ") gt ON TRUE ";
+static Game gameFromRow(const GameResultView::Row& row) {
+    Game game;
+    game.id = row.id();
+    game.name = std::string(row.name());
+    game.disk_space = row.diskSpace();
+    game.ram_usage = row.ramUsage();
+    game.vram_required = row.vramRequired();
+    game.genre_id = row.genreId();
+    game.genre = std::string(row.genre());
+    game.completed = row.completed();
+    game.url = std::string(row.url());
+    game.user_id = row.userId();
+    game.rating = row.rating();
+    game.is_favorite = row.isFavorite();
+    game.is_installed = row.isInstalled();
+    game.has_notes = row.hasNotes();
+    game.notes_preview = std::string(row.notesPreview());
+    game.tags = std::string(row.tags());
+    return game;
+}
+static std::vector<std::string> splitTagNames(const std::string& tags) {
+    std::vector<std::string> names;
+    std::stringstream ss(tags);
+    std::string tag_name;
+    while (std::getline(ss, tag_name, ',')) {
+        size_t start = tag_name.find_first_not_of(" \t");
+        size_t end = tag_name.find_last_not_of(" \t");
+        if (start != std::string::npos && end != std::string::npos) {
+            names.push_back(tag_name.substr(start, end - start + 1));
+        }
+    }
+    return names;
+}
+// Запись тегов игры в текущей транзакции: недостающие теги создаются одним запросом,
+// связи заменяются одним INSERT ... SELECT unnest
+static void writeGameTags(pqxx::work& txn, const Game& game, int game_id, bool replace) {
+    std::vector<int> tag_ids = game.tag_ids;
+    if (tag_ids.empty() && !game.tags.empty()) {
+        std::vector<std::string> names = splitTagNames(game.tags);
+        if (!names.empty()) {
+            pqxx::result r = txn.exec_params(
+                "WITH names AS (SELECT DISTINCT unnest($2::text[]) AS name), "
+                "added AS (INSERT INTO tags (name, user_id) SELECT name, $1 FROM names "
+                "          ON CONFLICT (name, user_id) DO NOTHING RETURNING id) "
+                "SELECT id FROM added "
+                "UNION SELECT t.id FROM tags t INNER JOIN names n ON n.name = t.name WHERE t.user_id = $1",
+                game.user_id, names
+            );
+            for (const auto& row : r) {
+                tag_ids.push_back(row[0].as<int>());
+            }
+        }
+    }
+    if (replace) {
+        txn.exec_params("DELETE FROM game_tags WHERE game_id = $1", game_id);
+    }
+    if (!tag_ids.empty()) {
+        txn.exec_params(
+            "INSERT INTO game_tags (game_id, tag_id) SELECT $1, unnest($2::int[]) ON CONFLICT DO NOTHING",
+            game_id, tag_ids
+        );
+    }
+}
+bool DatabaseManager::addGame(const Game& game, Game* saved) {
     try {
-        pqxx::work txn(*conn_);
+        Work txn(*this);
         int genre_id = game.genre_id;
         if (genre_id == 0 && !game.genre.empty()) {
-            pqxx::result gr = txn.exec_params(
+            pqxx::result gr = txn->exec_params(
                 "SELECT id FROM genres WHERE name = $1",
                 game.genre
             );
@@ -601,7 +931,7 @@ bool DatabaseManager::addGame(const Game& game) {
                 genre_id = gr[0][0].as<int>();
             }
         }
-        pqxx::result r = txn.exec_params(
+        pqxx::result r = txn->exec_params(
             "INSERT INTO games (name, disk_space, ram_usage, vram_required, genre_id, "
             "completed, url, user_id, rating, is_favorite, is_installed, notes) "
             "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12) RETURNING id",
@@ -610,45 +940,24 @@ bool DatabaseManager::addGame(const Game& game) {
             game.is_installed, game.notes
         );
         int new_game_id = r[0][0].as<int>();
-        txn.commit();
-        if (!game.tag_ids.empty()) {
-            setGameTags(new_game_id, game.tag_ids);
-        } else if (!game.tags.empty()) {
-            std::vector<int> tag_ids;
-            std::stringstream ss(game.tags);
-            std::string tag_name;
-            while (std::getline(ss, tag_name, ',')) {
-                size_t start = tag_name.find_first_not_of(" \t");
-                size_t end = tag_name.find_last_not_of(" \t");
-                if (start != std::string::npos && end != std::string::npos) {
-                    tag_name = tag_name.substr(start, end - start + 1);
-                    Tag existing = getTagByName(tag_name, game.user_id);
-                    if (existing.id > 0) {
-                        tag_ids.push_back(existing.id);
-                    } else {
-                        int new_tag_id = addTag(tag_name, game.user_id);
-                        if (new_tag_id > 0) {
-                            tag_ids.push_back(new_tag_id);
-                        }
-                    }
-                }
-            }
-            if (!tag_ids.empty()) {
-                setGameTags(new_game_id, tag_ids);
-            }
+        writeGameTags(*txn, game, new_game_id, false);
+        if (saved) {
+            pqxx::result row = txn->exec_params(GAME_ROW_SELECT + "WHERE g.id = $1", new_game_id);
+            *saved = gameFromRow(GameResultView(row)[0]);
         }
+        txn.commit();
         return true;
     } catch (const std::exception& e) {
         last_error_ = std::string("Add game error: ") + e.what();
         return false;
     }
 }
-bool DatabaseManager::updateGame(const Game& game) {
+bool DatabaseManager::updateGame(const Game& game, Game* saved) {
     try {
-        pqxx::work txn(*conn_);
+        Work txn(*this);
         int genre_id = game.genre_id;
         if (genre_id == 0 && !game.genre.empty()) {
-            pqxx::result gr = txn.exec_params(
+            pqxx::result gr = txn->exec_params(
                 "SELECT id FROM genres WHERE name = $1",
                 game.genre
             );
@@ -656,42 +965,27 @@ bool DatabaseManager::updateGame(const Game& game) {
                 genre_id = gr[0][0].as<int>();
             }
         }
-        txn.exec_params(
+        pqxx::result r = txn->exec_params(
             "UPDATE games SET name = $1, disk_space = $2, ram_usage = $3, "
             "vram_required = $4, genre_id = $5, completed = $6, url = $7, "
             "rating = $8, is_favorite = $9, is_installed = $10, notes = $11 "
-            "WHERE id = $12 AND user_id = $13",
+            "WHERE id = $12 AND user_id = $13 RETURNING id",
             game.name, game.disk_space, game.ram_usage, game.vram_required, genre_id,
             game.completed, game.url, game.rating, game.is_favorite, game.is_installed,
             game.notes, game.id, game.user_id
         );
-        txn.commit();
-        if (!game.tag_ids.empty()) {
-            setGameTags(game.id, game.tag_ids);
-        } else if (!game.tags.empty()) {
-            std::vector<int> tag_ids;
-            std::stringstream ss(game.tags);
-            std::string tag_name;
-            while (std::getline(ss, tag_name, ',')) {
-                size_t start = tag_name.find_first_not_of(" \t");
-                size_t end = tag_name.find_last_not_of(" \t");
-                if (start != std::string::npos && end != std::string::npos) {
-                    tag_name = tag_name.substr(start, end - start + 1);
-                    Tag existing = getTagByName(tag_name, game.user_id);
-                    if (existing.id > 0) {
-                        tag_ids.push_back(existing.id);
-                    } else {
-                        int new_tag_id = addTag(tag_name, game.user_id);
-                        if (new_tag_id > 0) {
-                            tag_ids.push_back(new_tag_id);
-                        }
-                    }
-                }
-            }
-            setGameTags(game.id, tag_ids);
-        } else {
-            setGameTags(game.id, {});
+        if (r.empty()) {
+            last_error_ = "Update game error: game not found";
+            return false;
         }
+        writeGameTags(*txn, game, game.id, true);
+        if (saved) {
+            pqxx::result row = txn->exec_params(GAME_ROW_SELECT + "WHERE g.id = $1", game.id);
+            *saved = gameFromRow(GameResultView(row)[0]);
+        }
+        txn.commit();
+        // Строка записана целиком: отложенные значения устарели
+        txn.afterCommit([this, game_id = game.id]() { pending_writes_.erase(game_id); });
         return true;
     } catch (const std::exception& e) {
         last_error_ = std::string("Update game error: ") + e.what();
@@ -700,12 +994,13 @@ bool DatabaseManager::updateGame(const Game& game) {
 }
 bool DatabaseManager::deleteGame(int game_id, int user_id) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params(
+        Work txn(*this);
+        txn->exec_params(
             "DELETE FROM games WHERE id = $1 AND user_id = $2",
             game_id, user_id
         );
         txn.commit();
+        txn.afterCommit([this, game_id]() { pending_writes_.erase(game_id); });
         return true;
     } catch (const std::exception& e) {
         last_error_ = std::string("Delete game error: ") + e.what();
@@ -714,8 +1009,8 @@ bool DatabaseManager::deleteGame(int game_id, int user_id) {
 }
 bool DatabaseManager::deleteGameByName(const std::string& name, int user_id) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params(
+        Work txn(*this);
+        txn->exec_params(
             "DELETE FROM games WHERE name = $1 AND user_id = $2",
             name, user_id
         );
@@ -726,45 +1021,6 @@ bool DatabaseManager::deleteGameByName(const std::string& name, int user_id) {
         return false;
     }
 }
-std::vector<Game> DatabaseManager::getAllGames(int user_id) {
-    std::vector<Game> games;
-    try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
-            "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
-            "g.genre_id, COALESCE(gen.name, 'Unknown') as genre, g.completed, g.url, "
-            "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes "
-            "FROM games g "
-            "LEFT JOIN genres gen ON g.genre_id = gen.id "
-            "WHERE g.user_id = $1 "
-            "ORDER BY g.name",
-            user_id
-        );
-        for (const auto& row : r) {
-            Game game;
-            game.id = row["id"].as<int>();
-            game.name = row["name"].as<std::string>();
-            game.disk_space = row["disk_space"].as<double>();
-            game.ram_usage = row["ram_usage"].as<double>();
-            game.vram_required = row["vram_required"].as<double>();
-            game.genre_id = row["genre_id"].is_null() ? 0 : row["genre_id"].as<int>();
-            game.genre = row["genre"].as<std::string>();
-            game.completed = row["completed"].as<bool>();
-            game.url = row["url"].is_null() ? "" : row["url"].as<std::string>();
-            game.user_id = row["user_id"].as<int>();
-            game.rating = row["rating"].is_null() ? -1 : row["rating"].as<int>();
-            game.is_favorite = row["is_favorite"].is_null() ? false : row["is_favorite"].as<bool>();
-            game.is_installed = row["is_installed"].is_null() ? false : row["is_installed"].as<bool>();
-            game.notes = row["notes"].is_null() ? "" : row["notes"].as<std::string>();
-            game.tags = aggregateGameTags(game.id);
-            games.push_back(game);
-        }
-        txn.commit();
-    } catch (const std::exception& e) {
-        last_error_ = std::string("Get all games error: ") + e.what();
-    }
-    return games;
-}
 std::string DatabaseManager::buildFilterCondition(const GameFilter& filter, int user_id) {
     std::stringstream ss;
     ss << "g.user_id = " << user_id;
@@ -808,52 +1064,187 @@ std::string DatabaseManager::buildFilterCondition(const GameFilter& filter, int
     if (filter.filter_tag && filter.tag_id > 0) {
         ss << " AND EXISTS (SELECT 1 FROM game_tags gt WHERE gt.game_id = g.id AND gt.tag_id = " << filter.tag_id << ")";
     }
+    if (filter.filter_name && !filter.name_query.empty()) {
+        ss << " AND g.name ILIKE " << conn_->quote(likeContainsPattern(filter.name_query));
+    }
     return ss.str();
 }
-std::vector<Game> DatabaseManager::getFilteredGames(int user_id, const GameFilter& filter) {
-    std::vector<Game> games;
+// Выражение порядка; должно совпадать с выражением индекса из initializeTables,
+// иначе планировщик не сможет читать страницу по индексу
+static const char* sortExpression(GameSort::Column column) {
+    switch (column) {
+    case GameSort::ByName:          return "g.name";
+    case GameSort::ByDiskSpace:     return "g.disk_space";
+    case GameSort::ByRamUsage:      return "g.ram_usage";
+    case GameSort::ByVramRequired:  return "g.vram_required";
+    case GameSort::ByGenre:         return "COALESCE(g.genre_id, 0)";
+    case GameSort::ByRating:        return "COALESCE(g.rating, -1)";
+    }
+    return "g.name";
+}
+// Значение ключа страницы литералом SQL. Дробные столбцы — кратчайшей записью,
+// которая читается обратно в то же double (как их отдаёт сервер)
+static std::string sortKeyLiteral(pqxx::work& txn, const GameSort& sort, const GamePageKey& key) {
+    switch (sort.column) {
+    case GameSort::ByName:
+        return txn.quote(key.name);
+    case GameSort::ByGenre:
+    case GameSort::ByRating:
+        return std::to_string(static_cast<int>(key.value));
+    default: {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), key.value);
+        return "'" + std::string(buffer, result.ptr) + "'::float8";
+    }
+    }
+}
+GameResultView DatabaseManager::getGamesPage(int user_id, const GameFilter* filter, const GameSort& sort,
+                                             const GamePageKey& after, int limit, bool* ok) {
+    GameResultView games;
+    if (ok) *ok = false;
     try {
-        pqxx::work txn(*conn_);
-        std::string condition = buildFilterCondition(filter, user_id);
-        std::string query = 
-            "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
-            "g.genre_id, COALESCE(gen.name, 'Unknown') as genre, g.completed, g.url, "
-            "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes "
-            "FROM games g "
-            "LEFT JOIN genres gen ON g.genre_id = gen.id "
-            "WHERE " + condition + " "
-            "ORDER BY g.name";
-        pqxx::result r = txn.exec(query);
-        for (const auto& row : r) {
-            Game game;
-            game.id = row["id"].as<int>();
-            game.name = row["name"].as<std::string>();
-            game.disk_space = row["disk_space"].as<double>();
-            game.ram_usage = row["ram_usage"].as<double>();
-            game.vram_required = row["vram_required"].as<double>();
-            game.genre_id = row["genre_id"].is_null() ? 0 : row["genre_id"].as<int>();
-            game.genre = row["genre"].as<std::string>();
-            game.completed = row["completed"].as<bool>();
-            game.url = row["url"].is_null() ? "" : row["url"].as<std::string>();
-            game.user_id = row["user_id"].as<int>();
-            game.rating = row["rating"].is_null() ? -1 : row["rating"].as<int>();
-            game.is_favorite = row["is_favorite"].is_null() ? false : row["is_favorite"].as<bool>();
-            game.is_installed = row["is_installed"].is_null() ? false : row["is_installed"].as<bool>();
-            game.notes = row["notes"].is_null() ? "" : row["notes"].as<std::string>();
-            game.tags = aggregateGameTags(game.id);
-            games.push_back(game);
+        Work txn(*this);
+        std::string condition = filter ? buildFilterCondition(*filter, user_id)
+                                       : "g.user_id = " + std::to_string(user_id);
+        std::string expression = sortExpression(sort.column);
+        const char* direction = sort.descending ? " DESC" : "";
+        if (after.valid) {
+            // Сравнение строк целиком: условие совпадает с порядком индекса (user_id, столбец, id)
+            condition += " AND (" + expression + ", g.id) " + (sort.descending ? "<" : ">") +
+                         " (" + sortKeyLiteral(*txn, sort, after) + ", " + std::to_string(after.id) + ")";
         }
+        pqxx::result r = txn->exec(
+            GAME_ROW_SELECT +
+            "WHERE " + condition + " "
+            "ORDER BY " + expression + direction + ", g.id" + direction + " "
+            "LIMIT " + std::to_string(limit)
+        );
         txn.commit();
+        games = GameResultView(std::move(r));
+        if (ok) *ok = true;
     } catch (const std::exception& e) {
-        last_error_ = std::string("Get filtered games error: ") + e.what();
+        last_error_ = std::string("Get games page error: ") + e.what();
     }
     return games;
 }
+static const std::string GAMES_COUNT_SELECT = "SELECT COUNT(*) FROM games g WHERE ";
+int DatabaseManager::countGames(int user_id, const GameFilter* filter, bool* ok) {
+    if (ok) *ok = false;
+    try {
+        Work txn(*this);
+        std::string condition = filter ? buildFilterCondition(*filter, user_id)
+                                       : "g.user_id = " + std::to_string(user_id);
+        pqxx::result r = txn->exec(GAMES_COUNT_SELECT + condition);
+        txn.commit();
+        if (ok) *ok = true;
+        return r[0][0].as<int>();
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Count games error: ") + e.what();
+        return 0;
+    }
+}
+static std::string facetEdgesArray(const double* edges, size_t count) {
+    std::string array = "ARRAY[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) array += ", ";
+        array += std::to_string(edges[i]);
+    }
+    return array + "]::float8[]";
+}
+FacetCounts DatabaseManager::getFacetCounts(int user_id, const GameFilter& filter, bool* ok) {
+    FacetCounts counts;
+    if (ok) *ok = false;
+    try {
+        // Условие фильтра без критериев одной фасеты
+        auto conditionWithout = [&](auto clear) {
+            GameFilter relaxed = filter;
+            clear(relaxed);
+            return "(" + buildFilterCondition(relaxed, user_id) + ")";
+        };
+        std::string query =
+            "SELECT GROUPING(genre_id) AS by_genre, GROUPING(tag_id) AS by_tag, "
+            "GROUPING(disk_bucket) AS by_disk, GROUPING(ram_bucket) AS by_ram, GROUPING(vram_bucket) AS by_vram, "
+            "genre_id, tag_id, disk_bucket, ram_bucket, vram_bucket, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_all) AS total, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_genre) AS genre_count, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_tag) AS tag_count, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_disk) AS disk_count, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_ram) AS ram_count, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_vram) AS vram_count, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_completed AND completed) AS completed_yes, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_completed AND NOT completed) AS completed_no, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_favorite AND is_favorite) AS favorite_yes, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_favorite AND NOT is_favorite) AS favorite_no, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_installed AND is_installed) AS installed_yes, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_installed AND NOT is_installed) AS installed_no, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_rated AND rating >= 0) AS rated_yes, "
+            "COUNT(DISTINCT id) FILTER (WHERE m_rated AND rating < 0) AS rated_no "
+            "FROM ("
+            "    SELECT g.id, g.genre_id, gtj.tag_id, "
+            "    COALESCE(g.completed, FALSE) AS completed, COALESCE(g.is_favorite, FALSE) AS is_favorite, "
+            "    COALESCE(g.is_installed, FALSE) AS is_installed, COALESCE(g.rating, -1) AS rating, "
+            "    width_bucket(g.disk_space, " + facetEdgesArray(DISK_FACET_EDGES.data(), DISK_FACET_EDGES.size()) + ") AS disk_bucket, "
+            "    width_bucket(g.ram_usage, " + facetEdgesArray(RAM_FACET_EDGES.data(), RAM_FACET_EDGES.size()) + ") AS ram_bucket, "
+            "    width_bucket(g.vram_required, " + facetEdgesArray(VRAM_FACET_EDGES.data(), VRAM_FACET_EDGES.size()) + ") AS vram_bucket, "
+            "    " + conditionWithout([](GameFilter&) {}) + " AS m_all, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_genre = false; }) + " AS m_genre, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_tag = false; }) + " AS m_tag, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_disk_space_min = f.filter_disk_space_max = false; }) + " AS m_disk, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_ram_min = f.filter_ram_max = false; }) + " AS m_ram, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_vram_min = f.filter_vram_max = false; }) + " AS m_vram, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_completed = false; }) + " AS m_completed, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_favorite = false; }) + " AS m_favorite, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_installed = false; }) + " AS m_installed, "
+            "    " + conditionWithout([](GameFilter& f) { f.filter_has_rating = false; }) + " AS m_rated "
+            "    FROM games g "
+            "    LEFT JOIN game_tags gtj ON gtj.game_id = g.id "
+            "    WHERE g.user_id = " + std::to_string(user_id) +
+            ") s "
+            "GROUP BY GROUPING SETS ((genre_id), (tag_id), (disk_bucket), (ram_bucket), (vram_bucket), ())";
+        Work txn(*this);
+        pqxx::result r = txn->exec(query);
+        txn.commit();
+        auto storeBucket = [](auto& buckets, const pqxx::field& bucket, int count) {
+            if (bucket.is_null()) return;
+            size_t index = static_cast<size_t>(bucket.as<int>());
+            if (index < buckets.size()) buckets[index] = count;
+        };
+        for (const auto& row : r) {
+            if (row["by_genre"].as<int>() == 0) {
+                if (!row["genre_id"].is_null()) {
+                    counts.genres[row["genre_id"].as<int>()] = row["genre_count"].as<int>();
+                }
+            } else if (row["by_tag"].as<int>() == 0) {
+                if (!row["tag_id"].is_null()) {
+                    counts.tags[row["tag_id"].as<int>()] = row["tag_count"].as<int>();
+                }
+            } else if (row["by_disk"].as<int>() == 0) {
+                storeBucket(counts.disk, row["disk_bucket"], row["disk_count"].as<int>());
+            } else if (row["by_ram"].as<int>() == 0) {
+                storeBucket(counts.ram, row["ram_bucket"], row["ram_count"].as<int>());
+            } else if (row["by_vram"].as<int>() == 0) {
+                storeBucket(counts.vram, row["vram_bucket"], row["vram_count"].as<int>());
+            } else {
+                counts.total = row["total"].as<int>();
+                counts.all_genres = row["genre_count"].as<int>();
+                counts.all_tags = row["tag_count"].as<int>();
+                counts.completed = {row["completed_no"].as<int>(), row["completed_yes"].as<int>()};
+                counts.favorite = {row["favorite_no"].as<int>(), row["favorite_yes"].as<int>()};
+                counts.installed = {row["installed_no"].as<int>(), row["installed_yes"].as<int>()};
+                counts.rated = {row["rated_no"].as<int>(), row["rated_yes"].as<int>()};
+            }
+        }
+        if (ok) *ok = true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Get facet counts error: ") + e.what();
+    }
+    return counts;
+}
 Game DatabaseManager::getGameById(int game_id, int user_id) {
     Game game;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
             "g.genre_id, COALESCE(gen.name, 'Unknown') as genre, g.completed, g.url, "
             "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes "
@@ -877,6 +1268,7 @@ Game DatabaseManager::getGameById(int game_id, int user_id) {
             game.is_favorite = r[0]["is_favorite"].is_null() ? false : r[0]["is_favorite"].as<bool>();
             game.is_installed = r[0]["is_installed"].is_null() ? false : r[0]["is_installed"].as<bool>();
             game.notes = r[0]["notes"].is_null() ? "" : r[0]["notes"].as<std::string>();
+            game.has_notes = !game.notes.empty();
             game.tags = aggregateGameTags(game.id);
         }
         txn.commit();
@@ -888,8 +1280,8 @@ Game DatabaseManager::getGameById(int game_id, int user_id) {
 Game DatabaseManager::getGameByName(const std::string& name, int user_id) {
     Game game;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
             "g.genre_id, COALESCE(gen.name, 'Unknown') as genre, g.completed, g.url, "
             "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes "
@@ -913,6 +1305,7 @@ Game DatabaseManager::getGameByName(const std::string& name, int user_id) {
             game.is_favorite = r[0]["is_favorite"].is_null() ? false : r[0]["is_favorite"].as<bool>();
             game.is_installed = r[0]["is_installed"].is_null() ? false : r[0]["is_installed"].as<bool>();
             game.notes = r[0]["notes"].is_null() ? "" : r[0]["notes"].as<std::string>();
+            game.has_notes = !game.notes.empty();
             game.tags = aggregateGameTags(game.id);
         }
         txn.commit();
@@ -923,64 +1316,391 @@ Game DatabaseManager::getGameByName(const std::string& name, int user_id) {
 }
 bool DatabaseManager::updateGameNotes(int game_id, int user_id, const std::string& notes) {
     try {
-        pqxx::work txn(*conn_);
-        txn.exec_params(
+        Work txn(*this);
+        txn->exec_params(
             "UPDATE games SET notes = $1 WHERE id = $2 AND user_id = $3",
             notes, game_id, user_id
         );
         txn.commit();
+        txn.afterCommit([this, game_id]() {
+            auto pending = pending_writes_.find(game_id);
+            if (pending != pending_writes_.end()) {
+                pending->second.notes.reset();
+            }
+        });
         return true;
     } catch (const std::exception& e) {
         last_error_ = std::string("Update notes error: ") + e.what();
         return false;
     }
 }
-GameStats DatabaseManager::getGameStats(int user_id) {
-    GameStats stats;
+std::string DatabaseManager::getGameNotes(int game_id, int user_id, bool* ok) {
+    if (const std::string* pending = pendingGameNotes(game_id)) {
+        if (ok) *ok = true;
+        return *pending;
+    }
+    std::string notes;
+    if (ok) *ok = false;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
-            "SELECT COUNT(*) FROM games WHERE user_id = $1",
-            user_id
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
+            "SELECT COALESCE(notes, '') FROM games WHERE id = $1 AND user_id = $2",
+            game_id, user_id
         );
-        stats.total_games = r[0][0].as<int>();
-        r = txn.exec_params(
-            "SELECT COUNT(*) FROM games WHERE user_id = $1 AND is_favorite = TRUE",
-            user_id
+        if (!r.empty()) {
+            notes = r[0][0].as<std::string>();
+        }
+        txn.commit();
+        if (ok) *ok = true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Get notes error: ") + e.what();
+    }
+    return notes;
+}
+void DatabaseManager::queueGameNotes(int game_id, int user_id, const std::string& notes) {
+    PendingGameWrite& write = pending_writes_[game_id];
+    write.user_id = user_id;
+    write.notes = notes;
+}
+void DatabaseManager::queueGameFlag(int game_id, int user_id, GameFlag flag, bool value) {
+    PendingGameWrite& write = pending_writes_[game_id];
+    write.user_id = user_id;
+    int& column = flag == GameFlag::Favorite ? write.favorite
+                : flag == GameFlag::Installed ? write.installed : write.completed;
+    column = value ? 1 : 0;
+}
+size_t DatabaseManager::pendingWriteCount() const {
+    size_t count = 0;
+    for (const auto& [game_id, write] : pending_writes_) {
+        count += (write.notes ? 1 : 0) + (write.favorite >= 0 ? 1 : 0) +
+                 (write.installed >= 0 ? 1 : 0) + (write.completed >= 0 ? 1 : 0);
+    }
+    return count;
+}
+const std::string* DatabaseManager::pendingGameNotes(int game_id) const {
+    auto pending = pending_writes_.find(game_id);
+    if (pending == pending_writes_.end() || !pending->second.notes) return nullptr;
+    return &*pending->second.notes;
+}
+bool DatabaseManager::flushPendingWrites() {
+    if (pending_writes_.empty()) return true;
+    // Строка на игру; столбцы, не изменённые в очереди, сохраняют значение из таблицы
+    std::vector<int> ids, user_ids, notes_set, favorites, installed, completed;
+    std::vector<std::string> notes;
+    for (const auto& [game_id, write] : pending_writes_) {
+        ids.push_back(game_id);
+        user_ids.push_back(write.user_id);
+        notes_set.push_back(write.notes ? 1 : 0);
+        notes.push_back(write.notes ? *write.notes : std::string());
+        favorites.push_back(write.favorite);
+        installed.push_back(write.installed);
+        completed.push_back(write.completed);
+    }
+    try {
+        Work txn(*this);
+        txn->exec_params(
+            "UPDATE games g SET "
+            "notes = CASE WHEN v.notes_set = 1 THEN v.notes ELSE g.notes END, "
+            "is_favorite = CASE WHEN v.favorite < 0 THEN g.is_favorite ELSE v.favorite = 1 END, "
+            "is_installed = CASE WHEN v.installed < 0 THEN g.is_installed ELSE v.installed = 1 END, "
+            "completed = CASE WHEN v.completed < 0 THEN g.completed ELSE v.completed = 1 END "
+            "FROM unnest($1::int[], $2::int[], $3::int[], $4::text[], $5::int[], $6::int[], $7::int[]) "
+            "AS v(id, user_id, notes_set, notes, favorite, installed, completed) "
+            "WHERE g.id = v.id AND g.user_id = v.user_id",
+            ids, user_ids, notes_set, notes, favorites, installed, completed
         );
-        stats.favorites_count = r[0][0].as<int>();
-        r = txn.exec_params(
-            "SELECT COUNT(*) FROM games WHERE user_id = $1 AND completed = TRUE",
-            user_id
+        txn.commit();
+        // Снимаются только записанные игры: в единице работы очередь могла пополниться до фиксации
+        txn.afterCommit([this, ids]() {
+            for (int game_id : ids) {
+                pending_writes_.erase(game_id);
+            }
+        });
+        return true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Flush pending writes error: ") + e.what();
+        return false;
+    }
+}
+bool DatabaseManager::deleteGames(const std::vector<int>& game_ids, int user_id) {
+    if (game_ids.empty()) return true;
+    try {
+        Work txn(*this);
+        txn->exec_params("DELETE FROM games WHERE id = ANY($1) AND user_id = $2", game_ids, user_id);
+        txn.commit();
+        txn.afterCommit([this, game_ids]() {
+            for (int game_id : game_ids) {
+                pending_writes_.erase(game_id);
+            }
+        });
+        return true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Delete games error: ") + e.what();
+        return false;
+    }
+}
+// Изменённые строки пакетной операции одним запросом, в той же транзакции
+static void readUpdatedGames(pqxx::work& txn, const std::vector<int>& game_ids, int user_id,
+                             GameResultView* updated) {
+    if (updated) {
+        *updated = GameResultView(txn.exec_params(
+            GAME_ROW_SELECT + "WHERE g.id = ANY($1) AND g.user_id = $2", game_ids, user_id));
+    }
+}
+bool DatabaseManager::setGamesGenre(const std::vector<int>& game_ids, int user_id, int genre_id,
+                                    GameResultView* updated) {
+    if (game_ids.empty()) return true;
+    try {
+        Work txn(*this);
+        txn->exec_params(
+            "UPDATE games SET genre_id = NULLIF($3, 0) WHERE id = ANY($1) AND user_id = $2",
+            game_ids, user_id, genre_id
         );
-        stats.completed_count = r[0][0].as<int>();
-        r = txn.exec_params(
-            "SELECT COUNT(*) FROM games WHERE user_id = $1 AND rating = -1",
-            user_id
+        readUpdatedGames(*txn, game_ids, user_id, updated);
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Set games genre error: ") + e.what();
+        return false;
+    }
+}
+bool DatabaseManager::setGamesFlag(const std::vector<int>& game_ids, int user_id, GameFlag flag, bool value,
+                                   GameResultView* updated) {
+    if (game_ids.empty()) return true;
+    // Имя столбца из перечисления, не из ввода
+    const char* column = flag == GameFlag::Favorite ? "is_favorite"
+                       : flag == GameFlag::Installed ? "is_installed" : "completed";
+    try {
+        Work txn(*this);
+        txn->exec_params(
+            std::string("UPDATE games SET ") + column + " = $3 WHERE id = ANY($1) AND user_id = $2",
+            game_ids, user_id, value
         );
-        stats.no_rating_count = r[0][0].as<int>();
-        r = txn.exec_params(
-            "SELECT COUNT(*), COALESCE(SUM(disk_space), 0) FROM games WHERE user_id = $1 AND is_installed = TRUE",
-            user_id
+        readUpdatedGames(*txn, game_ids, user_id, updated);
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Set games flag error: ") + e.what();
+        return false;
+    }
+}
+bool DatabaseManager::addTagToGames(const std::vector<int>& game_ids, int user_id, int tag_id,
+                                    GameResultView* updated) {
+    if (game_ids.empty()) return true;
+    try {
+        Work txn(*this);
+        txn->exec_params(
+            "INSERT INTO game_tags (game_id, tag_id) "
+            "SELECT g.id, t.id FROM games g INNER JOIN tags t ON t.id = $3 AND t.user_id = g.user_id "
+            "WHERE g.id = ANY($1) AND g.user_id = $2 "
+            "ON CONFLICT DO NOTHING",
+            game_ids, user_id, tag_id
         );
-        stats.installed_count = r[0][0].as<int>();
-        stats.installed_disk_space = r[0][1].as<double>();
-        r = txn.exec_params(
-            "SELECT COUNT(*) FROM games WHERE user_id = $1 AND (url IS NULL OR url = '')",
-            user_id
+        readUpdatedGames(*txn, game_ids, user_id, updated);
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Add tag to games error: ") + e.what();
+        return false;
+    }
+}
+bool DatabaseManager::removeTagFromGames(const std::vector<int>& game_ids, int user_id, int tag_id,
+                                         GameResultView* updated) {
+    if (game_ids.empty()) return true;
+    try {
+        Work txn(*this);
+        txn->exec_params(
+            "DELETE FROM game_tags gt USING games g "
+            "WHERE gt.game_id = g.id AND g.id = ANY($1) AND g.user_id = $2 AND gt.tag_id = $3",
+            game_ids, user_id, tag_id
         );
-        stats.no_url_count = r[0][0].as<int>();
+        readUpdatedGames(*txn, game_ids, user_id, updated);
         txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Remove tag from games error: ") + e.what();
+        return false;
+    }
+}
+static const char GAME_STATS_SELECT[] =
+    "SELECT COUNT(*), "
+    "COUNT(*) FILTER (WHERE is_favorite = TRUE), "
+    "COUNT(*) FILTER (WHERE completed = TRUE), "
+    "COUNT(*) FILTER (WHERE rating = -1), "
+    "COUNT(*) FILTER (WHERE is_installed = TRUE), "
+    "COALESCE(SUM(disk_space) FILTER (WHERE is_installed = TRUE), 0), "
+    "COUNT(*) FILTER (WHERE url IS NULL OR url = '') "
+    "FROM games WHERE user_id = $1";
+GameStats DatabaseManager::getGameStats(int user_id, bool* ok) {
+    GameStats stats;
+    if (ok) *ok = false;
+    try {
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(GAME_STATS_SELECT, user_id);
+        const pqxx::row row = r[0];
+        stats.total_games = fieldToInt(row[0], 0);
+        stats.favorites_count = fieldToInt(row[1], 0);
+        stats.completed_count = fieldToInt(row[2], 0);
+        stats.no_rating_count = fieldToInt(row[3], 0);
+        stats.installed_count = fieldToInt(row[4], 0);
+        stats.installed_disk_space = fieldToDouble(row[5], 0);
+        stats.no_url_count = fieldToInt(row[6], 0);
+        txn.commit();
+        if (ok) *ok = true;
     } catch (const std::exception& e) {
         last_error_ = std::string("Get stats error: ") + e.what();
     }
     return stats;
 }
+// Поле результата libpq в текстовом формате
+static std::string_view pgText(const PGresult* res, int row, int col) {
+    if (PQgetisnull(res, row, col)) return std::string_view();
+    return std::string_view(PQgetvalue(res, row, col), static_cast<size_t>(PQgetlength(res, row, col)));
+}
+template <typename T>
+static T pgNumber(const PGresult* res, int row, int col, T fallback) {
+    std::string_view text = pgText(res, row, col);
+    T value;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && ptr == text.data() + text.size() ? value : fallback;
+}
+// Разбор ответа конвейера; разбор совпадает с countGames/getGameStats/getUserTags/getAllGenres
+static void readPipelineResult(unsigned part, const PGresult* res, RefreshReads& reads) {
+    int rows = PQntuples(res);
+    if (part == RefreshReads::Count) {
+        reads.games_count = rows > 0 ? pgNumber<int>(res, 0, 0, 0) : 0;
+    } else if (part == RefreshReads::Stats) {
+        GameStats stats;
+        if (rows > 0) {
+            stats.total_games = pgNumber<int>(res, 0, 0, 0);
+            stats.favorites_count = pgNumber<int>(res, 0, 1, 0);
+            stats.completed_count = pgNumber<int>(res, 0, 2, 0);
+            stats.no_rating_count = pgNumber<int>(res, 0, 3, 0);
+            stats.installed_count = pgNumber<int>(res, 0, 4, 0);
+            stats.installed_disk_space = pgNumber<double>(res, 0, 5, 0);
+            stats.no_url_count = pgNumber<int>(res, 0, 6, 0);
+        }
+        reads.stats = stats;
+    } else if (part == RefreshReads::Tags) {
+        std::vector<Tag> tags;
+        tags.reserve(static_cast<size_t>(rows));
+        for (int i = 0; i < rows; ++i) {
+            Tag tag;
+            tag.id = pgNumber<int>(res, i, 0, 0);
+            tag.name = std::string(pgText(res, i, 1));
+            tag.user_id = pgNumber<int>(res, i, 2, 0);
+            tag.color = PQgetisnull(res, i, 3) ? "#808080" : std::string(pgText(res, i, 3));
+            tags.push_back(std::move(tag));
+        }
+        reads.tags = std::move(tags);
+    } else if (part == RefreshReads::Genres) {
+        std::vector<Genre> genres;
+        genres.reserve(static_cast<size_t>(rows));
+        for (int i = 0; i < rows; ++i) {
+            Genre genre;
+            genre.id = pgNumber<int>(res, i, 0, 0);
+            genre.name = std::string(pgText(res, i, 1));
+            genre.description = std::string(pgText(res, i, 2));
+            genres.push_back(std::move(genre));
+        }
+        reads.genres = std::move(genres);
+    }
+}
+pg_conn* DatabaseManager::pipelineConnection() {
+    if (pipeline_conn_ && PQstatus(pipeline_conn_) != CONNECTION_OK) {
+        closePipelineConnection();
+    }
+    if (!pipeline_conn_ && !conn_string_.empty()) {
+        pipeline_conn_ = PQconnectdb(conn_string_.c_str());
+        if (PQstatus(pipeline_conn_) != CONNECTION_OK) {
+            last_error_ = std::string("Connection error: ") + PQerrorMessage(pipeline_conn_);
+            closePipelineConnection();
+        }
+    }
+    return pipeline_conn_;
+}
+void DatabaseManager::closePipelineConnection() {
+    if (pipeline_conn_) {
+        PQfinish(pipeline_conn_);
+        pipeline_conn_ = nullptr;
+    }
+}
+unsigned DatabaseManager::readPipelined(unsigned parts, int user_id, const GameFilter* filter,
+                                        const std::function<void(const RefreshReads&)>& on_part) {
+#ifdef LIBPQ_HAS_PIPELINING
+    if (parts == 0) return 0;
+    PGconn* conn = pipelineConnection();
+    if (!conn) return 0;
+    if (PQenterPipelineMode(conn) != 1) {
+        last_error_ = std::string("Pipeline error: ") + PQerrorMessage(conn);
+        return 0;
+    }
+    std::string user_param = std::to_string(user_id);
+    const char* user_values[] = {user_param.c_str()};
+    std::string count_query;
+    if (parts & RefreshReads::Count) {
+        count_query = GAMES_COUNT_SELECT + (filter ? buildFilterCondition(*filter, user_id) : "g.user_id = " + user_param);
+    }
+    // Ответы приходят в порядке отправки
+    std::vector<unsigned> sent;
+    bool send_ok = true;
+    auto send = [&](unsigned part, const char* sql, bool with_user) {
+        if (!send_ok || !(parts & part)) return;
+        send_ok = PQsendQueryParams(conn, sql, with_user ? 1 : 0, nullptr, with_user ? user_values : nullptr,
+                                    nullptr, nullptr, 0) == 1;
+        if (send_ok) sent.push_back(part);
+    };
+    send(RefreshReads::Count, count_query.c_str(), false);
+    send(RefreshReads::Stats, GAME_STATS_SELECT, true);
+    send(RefreshReads::Tags, USER_TAGS_SELECT, true);
+    send(RefreshReads::Genres, GENRES_SELECT, false);
+    unsigned received = 0;
+    bool in_sync = send_ok && PQpipelineSync(conn) == 1;
+    for (size_t i = 0; in_sync && i < sent.size(); ++i) {
+        PGresult* res = PQgetResult(conn);
+        if (!res) {
+            in_sync = false;
+            break;
+        }
+        if (PQresultStatus(res) == PGRES_TUPLES_OK) {
+            RefreshReads reads;
+            readPipelineResult(sent[i], res, reads);
+            on_part(reads);
+            received |= sent[i];
+        } else if (PQresultStatus(res) != PGRES_PIPELINE_ABORTED) {
+            last_error_ = std::string("Pipeline query error: ") + PQresultErrorMessage(res);
+        }
+        PQclear(res);
+        // Ответ на каждый запрос завершается nullptr
+        if (PGresult* extra = PQgetResult(conn)) {
+            PQclear(extra);
+            in_sync = false;
+        }
+    }
+    if (in_sync) {
+        PGresult* sync = PQgetResult(conn);
+        in_sync = PQresultStatus(sync) == PGRES_PIPELINE_SYNC;
+        PQclear(sync);
+    }
+    // Подключение в неизвестном состоянии конвейера не переиспользуется
+    if (!in_sync || PQexitPipelineMode(conn) != 1) {
+        last_error_ = std::string("Pipeline error: ") + PQerrorMessage(conn);
+        closePipelineConnection();
+    }
+    return received;
+#else
+    (void)parts;
+    (void)user_id;
+    (void)filter;
+    (void)on_part;
+    return 0;
+#endif
+}
 std::vector<GenreStats> DatabaseManager::getGenreStatistics(int user_id) {
     std::vector<GenreStats> stats;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT gen.id, gen.name, "
             "COUNT(g.id) as games_count, "
             "COUNT(CASE WHEN g.completed THEN 1 END) as completed_count, "
@@ -1012,11 +1732,11 @@ std::vector<GenreStats> DatabaseManager::getGenreStatistics(int user_id) {
 std::vector<Game> DatabaseManager::getTopRatedGames(int user_id, int limit) {
     std::vector<Game> games;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
             "g.genre_id, COALESCE(gen.name, 'Unknown') as genre, g.completed, g.url, "
-            "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes "
+            "g.user_id, g.rating, g.is_favorite, g.is_installed, " + NOTES_SUMMARY_COLUMNS +
             "FROM games g "
             "LEFT JOIN genres gen ON g.genre_id = gen.id "
             "WHERE g.user_id = $1 AND g.rating >= 0 "
@@ -1024,6 +1744,7 @@ std::vector<Game> DatabaseManager::getTopRatedGames(int user_id, int limit) {
             "LIMIT $2",
             user_id, limit
         );
+        games.reserve(r.size());
         for (const auto& row : r) {
             Game game;
             game.id = row["id"].as<int>();
@@ -1039,8 +1760,8 @@ std::vector<Game> DatabaseManager::getTopRatedGames(int user_id, int limit) {
             game.rating = row["rating"].as<int>();
             game.is_favorite = row["is_favorite"].is_null() ? false : row["is_favorite"].as<bool>();
             game.is_installed = row["is_installed"].is_null() ? false : row["is_installed"].as<bool>();
-            game.notes = row["notes"].is_null() ? "" : row["notes"].as<std::string>();
-            games.push_back(game);
+            readNotesSummary(row, game);
+            games.push_back(std::move(game));
         }
         txn.commit();
     } catch (const std::exception& e) {
@@ -1051,11 +1772,11 @@ std::vector<Game> DatabaseManager::getTopRatedGames(int user_id, int limit) {
 std::vector<Game> DatabaseManager::getGamesWithTags(int user_id) {
     std::vector<Game> games;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
             "g.genre_id, COALESCE(gen.name, 'Unknown') as genre, g.completed, g.url, "
-            "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes, "
+            "g.user_id, g.rating, g.is_favorite, g.is_installed, " + NOTES_SUMMARY_COLUMNS + ", "
             "STRING_AGG(t.name, ', ' ORDER BY t.name) as tags "
             "FROM games g "
             "LEFT JOIN genres gen ON g.genre_id = gen.id "
@@ -1064,11 +1785,12 @@ std::vector<Game> DatabaseManager::getGamesWithTags(int user_id) {
             "WHERE g.user_id = $1 "
             "GROUP BY g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
             "g.genre_id, gen.name, g.completed, g.url, g.user_id, g.rating, "
-            "g.is_favorite, g.is_installed, g.notes "
+            "g.is_favorite, g.is_installed "
             "HAVING COUNT(t.id) > 0 "
             "ORDER BY g.name",
             user_id
         );
+        games.reserve(r.size());
         for (const auto& row : r) {
             Game game;
             game.id = row["id"].as<int>();
@@ -1084,9 +1806,9 @@ std::vector<Game> DatabaseManager::getGamesWithTags(int user_id) {
             game.rating = row["rating"].is_null() ? -1 : row["rating"].as<int>();
             game.is_favorite = row["is_favorite"].is_null() ? false : row["is_favorite"].as<bool>();
             game.is_installed = row["is_installed"].is_null() ? false : row["is_installed"].as<bool>();
-            game.notes = row["notes"].is_null() ? "" : row["notes"].as<std::string>();
+            readNotesSummary(row, game);
             game.tags = row["tags"].is_null() ? "" : row["tags"].as<std::string>();
-            games.push_back(game);
+            games.push_back(std::move(game));
         }
         txn.commit();
     } catch (const std::exception& e) {
@@ -1096,8 +1818,8 @@ std::vector<Game> DatabaseManager::getGamesWithTags(int user_id) {
 }
 double DatabaseManager::getAverageRatingByGenre(int genre_id, int user_id) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT AVG(rating) FROM games "
             "WHERE genre_id = $1 AND user_id = $2 AND rating >= 0",
             genre_id, user_id
@@ -1113,8 +1835,8 @@ double DatabaseManager::getAverageRatingByGenre(int genre_id, int user_id) {
 }
 int DatabaseManager::countGamesAboveRating(int user_id, int min_rating) {
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT genre_id, COUNT(*) as cnt "
             "FROM games "
             "WHERE user_id = $1 AND rating >= $2 "
@@ -1136,18 +1858,19 @@ int DatabaseManager::countGamesAboveRating(int user_id, int min_rating) {
 std::vector<Game> DatabaseManager::searchGames(int user_id, const std::string& search_term) {
     std::vector<Game> games;
     try {
-        pqxx::work txn(*conn_);
+        Work txn(*this);
         std::string pattern = "%" + search_term + "%";
-        pqxx::result r = txn.exec_params(
+        pqxx::result r = txn->exec_params(
             "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
             "g.genre_id, COALESCE(gen.name, 'Unknown') as genre, g.completed, g.url, "
-            "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes "
+            "g.user_id, g.rating, g.is_favorite, g.is_installed, " + NOTES_SUMMARY_COLUMNS +
             "FROM games g "
             "LEFT JOIN genres gen ON g.genre_id = gen.id "
             "WHERE g.user_id = $1 AND g.name ILIKE $2 "
             "ORDER BY g.name",
             user_id, pattern
         );
+        games.reserve(r.size());
         for (const auto& row : r) {
             Game game;
             game.id = row["id"].as<int>();
@@ -1163,8 +1886,8 @@ std::vector<Game> DatabaseManager::searchGames(int user_id, const std::string& s
             game.rating = row["rating"].is_null() ? -1 : row["rating"].as<int>();
             game.is_favorite = row["is_favorite"].is_null() ? false : row["is_favorite"].as<bool>();
             game.is_installed = row["is_installed"].is_null() ? false : row["is_installed"].as<bool>();
-            game.notes = row["notes"].is_null() ? "" : row["notes"].as<std::string>();
-            games.push_back(game);
+            readNotesSummary(row, game);
+            games.push_back(std::move(game));
         }
         txn.commit();
     } catch (const std::exception& e) {
@@ -1175,8 +1898,8 @@ std::vector<Game> DatabaseManager::searchGames(int user_id, const std::string& s
 std::vector<std::pair<std::string, int>> DatabaseManager::getTagUsageStats(int user_id) {
     std::vector<std::pair<std::string, int>> stats;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT t.name, COUNT(gt.game_id) as usage_count "
             "FROM tags t "
             "LEFT JOIN game_tags gt ON t.id = gt.tag_id "
@@ -1197,17 +1920,18 @@ std::vector<std::pair<std::string, int>> DatabaseManager::getTagUsageStats(int u
 std::vector<Game> DatabaseManager::getGamesCompletedByGenre(int user_id, int genre_id) {
     std::vector<Game> games;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
             "g.genre_id, gen.name as genre, g.completed, g.url, "
-            "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes "
+            "g.user_id, g.rating, g.is_favorite, g.is_installed, " + NOTES_SUMMARY_COLUMNS +
             "FROM games g "
             "INNER JOIN genres gen ON g.genre_id = gen.id "
             "WHERE g.user_id = $1 AND g.genre_id = $2 AND g.completed = TRUE "
             "ORDER BY g.rating DESC NULLS LAST, g.name",
             user_id, genre_id
         );
+        games.reserve(r.size());
         for (const auto& row : r) {
             Game game;
             game.id = row["id"].as<int>();
@@ -1223,8 +1947,8 @@ std::vector<Game> DatabaseManager::getGamesCompletedByGenre(int user_id, int gen
             game.rating = row["rating"].is_null() ? -1 : row["rating"].as<int>();
             game.is_favorite = row["is_favorite"].is_null() ? false : row["is_favorite"].as<bool>();
             game.is_installed = row["is_installed"].is_null() ? false : row["is_installed"].as<bool>();
-            game.notes = row["notes"].is_null() ? "" : row["notes"].as<std::string>();
-            games.push_back(game);
+            readNotesSummary(row, game);
+            games.push_back(std::move(game));
         }
         txn.commit();
     } catch (const std::exception& e) {
@@ -1235,11 +1959,11 @@ std::vector<Game> DatabaseManager::getGamesCompletedByGenre(int user_id, int gen
 std::vector<Game> DatabaseManager::getUnplayedHighRatedGames(int user_id) {
     std::vector<Game> games;
     try {
-        pqxx::work txn(*conn_);
-        pqxx::result r = txn.exec_params(
+        Work txn(*this);
+        pqxx::result r = txn->exec_params(
             "SELECT g.id, g.name, g.disk_space, g.ram_usage, g.vram_required, "
             "g.genre_id, gen.name as genre, g.completed, g.url, "
-            "g.user_id, g.rating, g.is_favorite, g.is_installed, g.notes "
+            "g.user_id, g.rating, g.is_favorite, g.is_installed, " + NOTES_SUMMARY_COLUMNS +
             "FROM games g "
             "INNER JOIN genres gen ON g.genre_id = gen.id "
             "WHERE g.user_id = $1 AND g.completed = FALSE "
@@ -1252,6 +1976,7 @@ std::vector<Game> DatabaseManager::getUnplayedHighRatedGames(int user_id) {
             "ORDER BY g.name",
             user_id
         );
+        games.reserve(r.size());
         for (const auto& row : r) {
             Game game;
             game.id = row["id"].as<int>();
@@ -1267,8 +1992,8 @@ std::vector<Game> DatabaseManager::getUnplayedHighRatedGames(int user_id) {
             game.rating = row["rating"].is_null() ? -1 : row["rating"].as<int>();
             game.is_favorite = row["is_favorite"].is_null() ? false : row["is_favorite"].as<bool>();
             game.is_installed = row["is_installed"].is_null() ? false : row["is_installed"].as<bool>();
-            game.notes = row["notes"].is_null() ? "" : row["notes"].as<std::string>();
-            games.push_back(game);
+            readNotesSummary(row, game);
+            games.push_back(std::move(game));
         }
         txn.commit();
     } catch (const std::exception& e) {
@@ -1276,87 +2001,418 @@ std::vector<Game> DatabaseManager::getUnplayedHighRatedGames(int user_id) {
     }
     return games;
 }
-bool DatabaseManager::writeGamesToFile(const std::string& filename, const std::vector<Game>& games) {
-    try {
-        std::ofstream file(filename, std::ios::binary);
-        if (!file.is_open()) {
-            last_error_ = "Cannot open file for writing: " + filename;
+static bool statVerifiedFileKey(const std::string& filename, VerifiedFileKey& key) {
+    struct stat st;
+    if (::stat(filename.c_str(), &st) != 0) {
+        return false;
+    }
+    char resolved[PATH_MAX];
+    key.path = ::realpath(filename.c_str(), resolved) ? std::string(resolved) : filename;
+    key.device = static_cast<uint64_t>(st.st_dev);
+    key.inode = static_cast<uint64_t>(st.st_ino);
+    key.size = static_cast<uint64_t>(st.st_size);
+    key.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+static std::string recordString(const char* data, size_t capacity) {
+    return std::string(data, strnlen(data, capacity));
+}
+static Game decodeGameRecord(const BinaryGameRecord& record) {
+    Game game;
+    game.id = record.id;
+    game.name = recordString(record.name, sizeof(record.name));
+    game.disk_space = record.disk_space;
+    game.ram_usage = record.ram_usage;
+    game.vram_required = record.vram_required;
+    game.genre_id = record.genre_id;
+    game.genre = recordString(record.genre, sizeof(record.genre));
+    game.completed = record.completed != 0;
+    game.url = recordString(record.url, sizeof(record.url));
+    game.user_id = record.user_id;
+    game.rating = record.rating;
+    game.is_favorite = record.is_favorite != 0;
+    game.is_installed = record.is_installed != 0;
+    game.notes = recordString(record.notes, sizeof(record.notes));
+    game.tags = recordString(record.tags, sizeof(record.tags));
+    return game;
+}
+static void copyRecordString(char* dest, size_t capacity, std::string_view value) {
+    size_t length = std::min(value.size(), capacity - 1);
+    std::memcpy(dest, value.data(), length);
+    dest[length] = '\0';
+}
+static void writeFileSection(std::ofstream& file, Sha256Stream& hasher, uint32_t tag,
+                             const void* data, uint64_t size) {
+    BinarySectionHeader section;
+    section.tag = tag;
+    section.size = size;
+    hasher.update(&section, sizeof(section));
+    hasher.update(data, static_cast<size_t>(size));
+    file.write(reinterpret_cast<const char*>(&section), sizeof(section));
+    if (size > 0) {
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+}
+static bool findFileSection(std::ifstream& file, const BinaryFileHeader& header, uint32_t tag,
+                            uint64_t& offset, uint64_t& size) {
+    if (header.version < 5 || header.footer_offset == 0) {
+        return false;
+    }
+    file.clear();
+    file.seekg(0, std::ios::end);
+    uint64_t file_size = static_cast<uint64_t>(file.tellg());
+    uint64_t position = header.footer_offset;
+    while (position + sizeof(BinarySectionHeader) <= file_size) {
+        BinarySectionHeader section;
+        file.seekg(static_cast<std::streamoff>(position));
+        if (!file.read(reinterpret_cast<char*>(&section), sizeof(section))) {
             return false;
         }
+        uint64_t data_offset = position + sizeof(section);
+        if (section.size > file_size - data_offset) {
+            return false;
+        }
+        if (section.tag == tag) {
+            offset = data_offset;
+            size = section.size;
+            return true;
+        }
+        position = data_offset + section.size;
+    }
+    return false;
+}
+template <typename Entry>
+static bool readIndexEntry(std::ifstream& file, uint64_t offset, uint64_t i, Entry& entry) {
+    file.seekg(static_cast<std::streamoff>(offset + i * sizeof(Entry)));
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&entry), sizeof(entry)));
+}
+static bool readRecordAt(std::ifstream& file, uint32_t record_no, BinaryGameRecord& record) {
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(sizeof(BinaryFileHeader) +
+                                           static_cast<uint64_t>(record_no) * sizeof(BinaryGameRecord)));
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&record), sizeof(record)));
+}
+// Столбцы запроса экспорта, в порядке SELECT
+enum ExportColumn {
+    ExportColId = 0,
+    ExportColName,
+    ExportColDiskSpace,
+    ExportColRamUsage,
+    ExportColVramRequired,
+    ExportColGenreId,
+    ExportColGenre,
+    ExportColCompleted,
+    ExportColUrl,
+    ExportColUserId,
+    ExportColRating,
+    ExportColFavorite,
+    ExportColInstalled,
+    ExportColNotes,
+    ExportColTags,
+    EXPORT_COLUMN_COUNT
+};
+bool DatabaseManager::streamGamesToFile(const std::string& filename, const std::string& condition,
+                                        const StreamExportOptions& options) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        last_error_ = "Cannot open file for writing: " + filename;
+        return false;
+    }
+    try {
         BinaryFileHeader header;
-        header.record_count = static_cast<uint32_t>(games.size());
-        std::vector<BinaryGameRecord> records;
-        for (const auto& game : games) {
-            BinaryGameRecord record;
-            record.id = game.id;
-            std::strncpy(record.name, game.name.c_str(), sizeof(record.name) - 1);
-            record.disk_space = game.disk_space;
-            record.ram_usage = game.ram_usage;
-            record.vram_required = game.vram_required;
-            record.genre_id = game.genre_id;
-            std::strncpy(record.genre, game.genre.c_str(), sizeof(record.genre) - 1);
-            record.completed = game.completed ? 1 : 0;
-            std::strncpy(record.url, game.url.c_str(), sizeof(record.url) - 1);
-            record.user_id = game.user_id;
-            record.rating = game.rating;
-            record.is_favorite = game.is_favorite ? 1 : 0;
-            record.is_installed = game.is_installed ? 1 : 0;
-            std::strncpy(record.notes, game.notes.c_str(), sizeof(record.notes) - 1);
-            std::strncpy(record.tags, game.tags.c_str(), sizeof(record.tags) - 1);
-            records.push_back(record);
-        }
-        std::string data_to_hash;
-        for (const auto& record : records) {
-            data_to_hash.append(reinterpret_cast<const char*>(&record), sizeof(record));
-        }
-        std::string hash = HashUtils::sha256(data_to_hash);
-        std::strncpy(header.hash, hash.c_str(), sizeof(header.hash) - 1);
         file.write(reinterpret_cast<const char*>(&header), sizeof(header));
-        for (const auto& record : records) {
+        Sha256Stream hasher;
+        uint32_t record_count = 0;
+        std::vector<BinaryNameIndexEntry> name_index;
+        std::vector<BinaryIdIndexEntry> id_index;
+        std::vector<uint32_t> record_crcs;
+        std::string snapshot_time;
+        if (options.snapshot_user_id != 0) {
+            // Отметка снимка — начало самой старой открытой транзакции, а не now(): updated_at и
+            // deleted_at берут время начала транзакции писателя, и правка, начатая до снимка и
+            // зафиксированная после него, иначе выпала бы из всех следующих дельт. Читается до
+            // снимка экспорта, чтобы каждый незавершённый к снимку писатель уже был в pg_stat_activity.
+            // Повтор строк в дельте безвреден: applyDelta вставляет с заменой по имени
+            pqxx::nontransaction probe(*conn_);
+            snapshot_time = probe.exec(
+                "SELECT LEAST(now(), MIN(xact_start))::timestamp::text FROM pg_stat_activity"
+            )[0][0].as<std::string>();
+        }
+        pqxx::transaction<pqxx::isolation_level::repeatable_read> txn(*conn_);
+        std::string where = condition;
+        std::vector<BinaryDeltaDeletion> deletions;
+        if (!options.base_hash.empty()) {
+            pqxx::result base = txn.exec_params(
+                "SELECT snapshot_at FROM export_snapshots WHERE hash = $1 AND user_id = $2",
+                options.base_hash, options.snapshot_user_id
+            );
+            if (base.empty()) {
+                throw std::runtime_error("base export is not registered in this database");
+            }
+            std::string base_time = base[0][0].as<std::string>();
+            pqxx::result deleted = txn.exec_params(
+                "SELECT DISTINCT d.name FROM game_deletions d "
+                "WHERE d.user_id = $1 AND d.deleted_at > $2::timestamp "
+                "AND NOT EXISTS (SELECT 1 FROM games g WHERE g.user_id = d.user_id AND g.name = d.name)",
+                options.snapshot_user_id, base_time
+            );
+            for (const auto& row : deleted) {
+                BinaryDeltaDeletion deletion;
+                copyRecordString(deletion.name, sizeof(deletion.name), row[0].as<std::string>());
+                deletions.push_back(deletion);
+            }
+            where += " AND g.updated_at > " + txn.quote(base_time) + "::timestamp";
+        }
+        // Явные приведения: двоичный COPY отдаёт значения в типе столбца (int4, float8, bool, text)
+        std::string query =
+            "SELECT g.id::int4, g.name::text, g.disk_space::float8, g.ram_usage::float8, "
+            "g.vram_required::float8, COALESCE(g.genre_id, 0)::int4, COALESCE(gen.name, 'Unknown')::text, "
+            "COALESCE(g.completed, FALSE), COALESCE(g.url, '')::text, g.user_id::int4, "
+            "COALESCE(g.rating, -1)::int4, COALESCE(g.is_favorite, FALSE), COALESCE(g.is_installed, FALSE), "
+            "COALESCE(g.notes, '')::text, COALESCE(gt.tags, '')::text "
+            "FROM games g "
+            "LEFT JOIN genres gen ON g.genre_id = gen.id "
+            "LEFT JOIN LATERAL ("
+            "    SELECT STRING_AGG(t.name, ', ' ORDER BY t.name) AS tags "
+            "    FROM game_tags gt2 INNER JOIN tags t ON t.id = gt2.tag_id "
+            "    WHERE gt2.game_id = g.id"
+            ") gt ON TRUE "
+            "WHERE " + where + " "
+            "ORDER BY g.name";
+        auto writeRecord = [&](const BinaryGameRecord& record, std::string_view name) {
+            hasher.update(&record, sizeof(record));
             file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            name_index.push_back({HashUtils::fnv1a64(name.data(), std::min(name.size(), sizeof(record.name) - 1)),
+                                  record_count});
+            id_index.push_back({record.id, record_count});
+            record_crcs.push_back(HashUtils::crc32c(&record, sizeof(record)));
+            ++record_count;
+        };
+        // Основной путь — двоичный COPY на отдельном соединении libpq в снимке этой транзакции:
+        // без текстового представления чисел и без разбора строк результата
+        std::string snapshot = txn.exec("SELECT pg_export_snapshot()")[0][0].as<std::string>();
+        BinaryCopyReader reader(conn_string_);
+        bool binary = reader.exec("BEGIN ISOLATION LEVEL REPEATABLE READ READ ONLY") &&
+                      reader.exec("SET TRANSACTION SNAPSHOT " + txn.quote(snapshot)) &&
+                      reader.start(query);
+        if (binary) {
+            while (reader.next()) {
+                if (reader.fieldCount() != EXPORT_COLUMN_COUNT) {
+                    throw std::runtime_error("unexpected COPY row layout");
+                }
+                BinaryGameRecord record;
+                record.id = reader.int4(ExportColId);
+                copyRecordString(record.name, sizeof(record.name), reader.text(ExportColName));
+                record.disk_space = reader.float8(ExportColDiskSpace);
+                record.ram_usage = reader.float8(ExportColRamUsage);
+                record.vram_required = reader.float8(ExportColVramRequired);
+                record.genre_id = reader.int4(ExportColGenreId);
+                copyRecordString(record.genre, sizeof(record.genre), reader.text(ExportColGenre));
+                record.completed = reader.boolean(ExportColCompleted) ? 1 : 0;
+                copyRecordString(record.url, sizeof(record.url), reader.text(ExportColUrl));
+                record.user_id = reader.int4(ExportColUserId);
+                record.rating = reader.int4(ExportColRating);
+                record.is_favorite = reader.boolean(ExportColFavorite) ? 1 : 0;
+                record.is_installed = reader.boolean(ExportColInstalled) ? 1 : 0;
+                copyRecordString(record.notes, sizeof(record.notes), reader.text(ExportColNotes));
+                copyRecordString(record.tags, sizeof(record.tags), reader.text(ExportColTags));
+                writeRecord(record, reader.text(ExportColName));
+            }
+            if (reader.failed()) {
+                throw std::runtime_error("binary COPY failed: " + reader.errorString());
+            }
+            reader.exec("COMMIT");
+        } else {
+            // Второе соединение недоступно — текстовый поток в той же транзакции
+            for (auto [id, name, disk_space, ram_usage, vram_required, genre_id, genre, completed,
+                       url, user_id, rating, is_favorite, is_installed, notes, tags] :
+                 txn.stream<int, std::string_view, double, double, double, int, std::string_view, bool,
+                            std::string_view, int, int, bool, bool, std::string_view, std::string_view>(query)) {
+                BinaryGameRecord record;
+                record.id = id;
+                copyRecordString(record.name, sizeof(record.name), name);
+                record.disk_space = disk_space;
+                record.ram_usage = ram_usage;
+                record.vram_required = vram_required;
+                record.genre_id = genre_id;
+                copyRecordString(record.genre, sizeof(record.genre), genre);
+                record.completed = completed ? 1 : 0;
+                copyRecordString(record.url, sizeof(record.url), url);
+                record.user_id = user_id;
+                record.rating = rating;
+                record.is_favorite = is_favorite ? 1 : 0;
+                record.is_installed = is_installed ? 1 : 0;
+                copyRecordString(record.notes, sizeof(record.notes), notes);
+                copyRecordString(record.tags, sizeof(record.tags), tags);
+                writeRecord(record, name);
+            }
+        }
+        std::sort(name_index.begin(), name_index.end(),
+            [](const BinaryNameIndexEntry& a, const BinaryNameIndexEntry& b) {
+                return a.name_hash != b.name_hash ? a.name_hash < b.name_hash : a.record_no < b.record_no;
+            });
+        std::sort(id_index.begin(), id_index.end(),
+            [](const BinaryIdIndexEntry& a, const BinaryIdIndexEntry& b) { return a.id < b.id; });
+        header.footer_offset = static_cast<uint64_t>(file.tellp());
+        header.flags |= FILE_FLAG_INDEX;
+        writeFileSection(file, hasher, SECTION_NAME_INDEX, name_index.data(),
+                         name_index.size() * sizeof(BinaryNameIndexEntry));
+        writeFileSection(file, hasher, SECTION_ID_INDEX, id_index.data(),
+                         id_index.size() * sizeof(BinaryIdIndexEntry));
+        header.flags |= FILE_FLAG_RECORD_CRC;
+        writeFileSection(file, hasher, SECTION_RECORD_CRC, record_crcs.data(),
+                         record_crcs.size() * sizeof(uint32_t));
+        if (!options.base_hash.empty()) {
+            BinaryDeltaInfo info;
+            std::memcpy(info.base_hash, options.base_hash.data(),
+                        std::min(options.base_hash.size(), sizeof(info.base_hash)));
+            info.deleted_count = static_cast<uint32_t>(deletions.size());
+            std::string payload(reinterpret_cast<const char*>(&info), sizeof(info));
+            payload.append(reinterpret_cast<const char*>(deletions.data()),
+                           deletions.size() * sizeof(BinaryDeltaDeletion));
+            header.flags |= FILE_FLAG_DELTA;
+            writeFileSection(file, hasher, SECTION_DELTA, payload.data(), payload.size());
+        }
+        std::string hash = hasher.finalHex();
+        if (hash.empty()) {
+            throw std::runtime_error("SHA-256 computation failed");
         }
+        header.record_count = record_count;
+        std::memcpy(header.hash, hash.data(), std::min(hash.size(), sizeof(header.hash)));
+        if (options.snapshot_user_id != 0) {
+            txn.exec_params(
+                "INSERT INTO export_snapshots (hash, user_id, snapshot_at, base_hash) "
+                "VALUES ($1, $2, $3::timestamp, NULLIF($4, '')) ON CONFLICT (hash) DO NOTHING",
+                hash, options.snapshot_user_id, snapshot_time, options.base_hash
+            );
+            // Удаления старше самого раннего снимка пользователя не войдут ни в одну дельту
+            txn.exec_params(
+                "DELETE FROM game_deletions WHERE user_id = $1 AND deleted_at < "
+                "(SELECT MIN(snapshot_at) FROM export_snapshots WHERE user_id = $1)",
+                options.snapshot_user_id
+            );
+        }
+        txn.commit();
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
         file.close();
-        return true;
+        if (!file) {
+            throw std::runtime_error("write failed");
+        }
     } catch (const std::exception& e) {
         last_error_ = std::string("Write file error: ") + e.what();
+        file.close();
+        std::remove(filename.c_str());
         return false;
     }
+    VerifiedFileKey key;
+    if (statVerifiedFileKey(filename, key)) {
+        rememberVerifiedFile(key);
+    }
+    return true;
 }
 bool DatabaseManager::exportToBinaryFile(const std::string& filename, int user_id) {
-    std::vector<Game> games = getAllGames(user_id);
-    return writeGamesToFile(filename, games);
+    StreamExportOptions options;
+    options.snapshot_user_id = user_id;
+    return streamGamesToFile(filename, "g.user_id = " + std::to_string(user_id), options);
 }
 bool DatabaseManager::exportFilteredToBinaryFile(const std::string& filename, int user_id, 
                                                    const GameFilter& filter) {
-    std::vector<Game> games = getFilteredGames(user_id, filter);
-    return writeGamesToFile(filename, games);
+    return streamGamesToFile(filename, buildFilterCondition(filter, user_id), StreamExportOptions());
+}
+bool DatabaseManager::exportDeltaToBinaryFile(const std::string& filename, int user_id,
+                                              const std::string& base_filename) {
+    std::ifstream base(base_filename, std::ios::binary);
+    BinaryFileHeader header;
+    if (!base.is_open() || !base.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != FILE_MAGIC) {
+        last_error_ = "Invalid base file: " + base_filename;
+        return false;
+    }
+    StreamExportOptions options;
+    options.snapshot_user_id = user_id;
+    options.base_hash = std::string(header.hash, strnlen(header.hash, sizeof(header.hash)));
+    return streamGamesToFile(filename, "g.user_id = " + std::to_string(user_id), options);
+}
+bool DatabaseManager::isFileVerified(const VerifiedFileKey& key) const {
+    return std::find(verified_files_.begin(), verified_files_.end(), key) != verified_files_.end();
+}
+void DatabaseManager::rememberVerifiedFile(const VerifiedFileKey& key) {
+    verified_files_.erase(std::remove_if(verified_files_.begin(), verified_files_.end(),
+        [&key](const VerifiedFileKey& cached) { return cached.path == key.path; }),
+        verified_files_.end());
+    verified_files_.insert(verified_files_.begin(), key);
+    if (verified_files_.size() > MAX_VERIFIED_FILES) {
+        verified_files_.resize(MAX_VERIFIED_FILES);
+    }
 }
 FileVerificationResult DatabaseManager::verifyBinaryFile(const std::string& filename) {
+    VerifiedFileKey key;
+    if (statVerifiedFileKey(filename, key) && isFileVerified(key)) {
+        return FileVerificationResult::OK;
+    }
+    std::vector<Game> games;
+    return readBinaryFile(filename, games);
+}
+FileVerificationResult DatabaseManager::readBinaryFile(const std::string& filename, std::vector<Game>& games) {
+    BinaryFileHeader header;
+    return readBinaryFileWithHeader(filename, games, header);
+}
+FileVerificationResult DatabaseManager::readBinaryFileWithHeader(const std::string& filename,
+                                                                 std::vector<Game>& games,
+                                                                 BinaryFileHeader& header) {
+    games.clear();
     try {
+        VerifiedFileKey key;
+        if (!statVerifiedFileKey(filename, key)) {
+            return FileVerificationResult::FILE_NOT_FOUND;
+        }
         std::ifstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             return FileVerificationResult::FILE_NOT_FOUND;
         }
-        BinaryFileHeader header;
-        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            return FileVerificationResult::READ_ERROR;
+        }
         if (header.magic != FILE_MAGIC) {
             return FileVerificationResult::INVALID_MAGIC;
         }
         if (header.version > FILE_VERSION) {
             return FileVerificationResult::INVALID_VERSION;
         }
-        std::string data_to_hash;
+        bool already_verified = isFileVerified(key);
+        Sha256Stream hasher;
+        // Счётчик из заголовка ещё не проверен хешем: резерв не больше, чем записей помещается в файл
+        uint64_t available = (key.size - sizeof(header)) / sizeof(BinaryGameRecord);
+        games.reserve(static_cast<size_t>(std::min<uint64_t>(header.record_count, available)));
         for (uint32_t i = 0; i < header.record_count; ++i) {
             BinaryGameRecord record;
-            file.read(reinterpret_cast<char*>(&record), sizeof(record));
-            data_to_hash.append(reinterpret_cast<const char*>(&record), sizeof(record));
+            if (!file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+                return FileVerificationResult::READ_ERROR;
+            }
+            if (!already_verified) {
+                hasher.update(&record, sizeof(record));
+            }
+            games.push_back(decodeGameRecord(record));
+        }
+        if (!already_verified && header.version >= 5) {
+            char buffer[64 * 1024];
+            while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+                hasher.update(buffer, static_cast<size_t>(file.gcount()));
+            }
         }
         file.close();
-        std::string computed_hash = HashUtils::sha256(data_to_hash);
+        if (already_verified) {
+            return FileVerificationResult::OK;
+        }
+        std::string computed_hash = hasher.finalHex();
         std::string stored_hash(header.hash, strnlen(header.hash, sizeof(header.hash)));
-        if (computed_hash != stored_hash) {
+        bool legacy_truncated = header.version < 5 && stored_hash.size() == sizeof(header.hash) - 1 &&
+                                computed_hash.compare(0, stored_hash.size(), stored_hash) == 0;
+        if (computed_hash.empty() || (computed_hash != stored_hash && !legacy_truncated)) {
             return FileVerificationResult::HASH_MISMATCH;
         }
+        rememberVerifiedFile(key);
         return FileVerificationResult::OK;
     } catch (const std::exception& e) {
         last_error_ = std::string("Verification error: ") + e.what();
@@ -1382,86 +2438,352 @@ std::string DatabaseManager::getVerificationErrorText(FileVerificationResult res
     }
 }
 bool DatabaseManager::importFromBinaryFile(const std::string& filename, int user_id) {
-    FileVerificationResult verification = verifyBinaryFile(filename);
+    FileVerificationResult verification;
+    return importFromBinaryFile(filename, user_id, verification);
+}
+bool DatabaseManager::importFromBinaryFile(const std::string& filename, int user_id,
+                                           FileVerificationResult& verification) {
+    std::vector<Game> games;
+    BinaryFileHeader header;
+    verification = readBinaryFileWithHeader(filename, games, header);
     if (verification != FileVerificationResult::OK) {
         last_error_ = getVerificationErrorText(verification);
         return false;
     }
     try {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file.is_open()) {
-            last_error_ = "Cannot open file for reading: " + filename;
-            return false;
+        if (header.flags & FILE_FLAG_DELTA) {
+            return applyDelta(filename, header, games, user_id);
         }
-        BinaryFileHeader header;
-        file.read(reinterpret_cast<char*>(&header), sizeof(header));
-        for (uint32_t i = 0; i < header.record_count; ++i) {
-            BinaryGameRecord record;
-            file.read(reinterpret_cast<char*>(&record), sizeof(record));
-            Game game;
-            game.name = record.name;
-            game.disk_space = record.disk_space;
-            game.ram_usage = record.ram_usage;
-            game.vram_required = record.vram_required;
-            game.genre = record.genre;
-            game.completed = record.completed != 0;
-            game.url = record.url;
+        for (auto& game : games) {
+            game.id = 0;
+            game.genre_id = 0;
             game.user_id = user_id;
-            game.rating = record.rating;
-            game.is_favorite = record.is_favorite != 0;
-            game.is_installed = record.is_installed != 0;
-            game.notes = record.notes;
-            game.tags = record.tags;
             addGame(game);
         }
-        file.close();
         return true;
     } catch (const std::exception& e) {
         last_error_ = std::string("Import error: ") + e.what();
         return false;
     }
 }
-std::vector<Game> DatabaseManager::readBinaryFile(const std::string& filename) {
-    std::vector<Game> games;
+static bool readDeltaSection(const std::string& filename, const BinaryFileHeader& header,
+                             std::string& base_hash, std::vector<std::string>* deleted) {
+    std::ifstream file(filename, std::ios::binary);
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    if (!file.is_open() || !findFileSection(file, header, SECTION_DELTA, offset, size) ||
+        size < sizeof(BinaryDeltaInfo)) {
+        return false;
+    }
+    BinaryDeltaInfo info;
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(reinterpret_cast<char*>(&info), sizeof(info)) ||
+        size < sizeof(info) + static_cast<uint64_t>(info.deleted_count) * sizeof(BinaryDeltaDeletion)) {
+        return false;
+    }
+    base_hash = recordString(info.base_hash, sizeof(info.base_hash));
+    if (deleted) {
+        deleted->clear();
+        for (uint32_t i = 0; i < info.deleted_count; ++i) {
+            BinaryDeltaDeletion deletion;
+            if (!file.read(reinterpret_cast<char*>(&deletion), sizeof(deletion))) {
+                return false;
+            }
+            deleted->push_back(recordString(deletion.name, sizeof(deletion.name)));
+        }
+    }
+    return true;
+}
+bool DatabaseManager::applyDelta(const std::string& filename, const BinaryFileHeader& header,
+                                 std::vector<Game>& games, int user_id) {
+    std::string base_hash;
+    std::vector<std::string> deleted;
+    if (!readDeltaSection(filename, header, base_hash, &deleted)) {
+        last_error_ = "Delta section is missing or damaged";
+        return false;
+    }
+    // Дельта применяется целиком или не применяется: иначе следующая в цепочке ляжет на неполную базу
+    UnitOfWork unit = batch();
+    for (const auto& name : deleted) {
+        deleteGameByName(name, user_id);
+    }
+    for (auto& game : games) {
+        Game existing = getGameByName(game.name, user_id);
+        game.id = existing.id;
+        game.genre_id = 0;
+        game.user_id = user_id;
+        if (existing.id > 0) {
+            updateGame(game);
+        } else {
+            addGame(game);
+        }
+    }
+    return unit.commit();
+}
+bool DatabaseManager::importDeltaChain(const std::vector<std::string>& filenames, int user_id) {
+    struct ChainFile {
+        std::string filename;
+        std::string hash;
+        std::string base_hash;
+        bool is_delta;
+    };
+    std::vector<ChainFile> pending;
+    for (const auto& filename : filenames) {
+        std::ifstream file(filename, std::ios::binary);
+        BinaryFileHeader header;
+        if (!file.is_open() || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            header.magic != FILE_MAGIC) {
+            last_error_ = "Invalid file format: " + filename;
+            return false;
+        }
+        ChainFile item{filename, std::string(header.hash, strnlen(header.hash, sizeof(header.hash))), "",
+                       (header.flags & FILE_FLAG_DELTA) != 0};
+        if (item.is_delta && !readDeltaSection(filename, header, item.base_hash, nullptr)) {
+            last_error_ = "Delta section is missing or damaged: " + filename;
+            return false;
+        }
+        pending.push_back(item);
+    }
+    std::vector<ChainFile> chain;
+    auto full = std::find_if(pending.begin(), pending.end(), [](const ChainFile& f) { return !f.is_delta; });
+    if (full == pending.end()) {
+        full = std::find_if(pending.begin(), pending.end(), [&pending](const ChainFile& f) {
+            return std::none_of(pending.begin(), pending.end(),
+                [&f](const ChainFile& other) { return other.hash == f.base_hash; });
+        });
+    }
+    if (full == pending.end()) {
+        last_error_ = "Delta chain has no starting point";
+        return false;
+    }
+    chain.push_back(*full);
+    pending.erase(full);
+    while (!pending.empty()) {
+        const std::string& current = chain.back().hash;
+        auto next = std::find_if(pending.begin(), pending.end(),
+            [&current](const ChainFile& f) { return f.is_delta && f.base_hash == current; });
+        if (next == pending.end()) {
+            last_error_ = "Delta chain is broken: no delta for base " + current;
+            return false;
+        }
+        chain.push_back(*next);
+        pending.erase(next);
+    }
+    for (const auto& item : chain) {
+        FileVerificationResult verification;
+        if (!importFromBinaryFile(item.filename, user_id, verification)) {
+            last_error_ = item.filename + ": " + last_error_;
+            return false;
+        }
+    }
+    return true;
+}
+FileVerificationResult DatabaseManager::scanRecordCrcs(const std::string& filename, std::vector<uint32_t>& damaged,
+                                                       std::vector<Game>* intact) {
+    damaged.clear();
     try {
         std::ifstream file(filename, std::ios::binary);
         if (!file.is_open()) {
-            last_error_ = "Cannot open file for reading: " + filename;
-            return games;
+            return FileVerificationResult::FILE_NOT_FOUND;
         }
         BinaryFileHeader header;
-        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            last_error_ = getVerificationErrorText(FileVerificationResult::READ_ERROR);
+            return FileVerificationResult::READ_ERROR;
+        }
         if (header.magic != FILE_MAGIC) {
+            return FileVerificationResult::INVALID_MAGIC;
+        }
+        if (header.version > FILE_VERSION) {
+            return FileVerificationResult::INVALID_VERSION;
+        }
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        if (!(header.flags & FILE_FLAG_RECORD_CRC) ||
+            !findFileSection(file, header, SECTION_RECORD_CRC, offset, size) ||
+            size != static_cast<uint64_t>(header.record_count) * sizeof(uint32_t)) {
+            last_error_ = "File has no per-record checksums";
+            return FileVerificationResult::READ_ERROR;
+        }
+        std::vector<uint32_t> crcs(header.record_count);
+        file.seekg(static_cast<std::streamoff>(offset));
+        file.read(reinterpret_cast<char*>(crcs.data()), static_cast<std::streamsize>(size));
+        if (!file) {
+            last_error_ = "Checksum section is damaged";
+            return FileVerificationResult::READ_ERROR;
+        }
+        file.seekg(sizeof(header));
+        constexpr uint32_t BATCH = 256;
+        std::vector<BinaryGameRecord> batch(BATCH);
+        for (uint32_t first = 0; first < header.record_count; first += BATCH) {
+            uint32_t count = std::min(BATCH, header.record_count - first);
+            file.read(reinterpret_cast<char*>(batch.data()), static_cast<std::streamsize>(count * sizeof(BinaryGameRecord)));
+            uint32_t available = static_cast<uint32_t>(file.gcount() / sizeof(BinaryGameRecord));
+            for (uint32_t i = 0; i < count; ++i) {
+                if (i >= available || HashUtils::crc32c(&batch[i], sizeof(BinaryGameRecord)) != crcs[first + i]) {
+                    damaged.push_back(first + i);
+                } else if (intact) {
+                    intact->push_back(decodeGameRecord(batch[i]));
+                }
+            }
+            if (available < count) {
+                for (uint32_t rest = first + count; rest < header.record_count; ++rest) {
+                    damaged.push_back(rest);
+                }
+                break;
+            }
+        }
+        return damaged.empty() ? FileVerificationResult::OK : FileVerificationResult::HASH_MISMATCH;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Checksum scan error: ") + e.what();
+        return FileVerificationResult::READ_ERROR;
+    }
+}
+FileVerificationResult DatabaseManager::quickCheckBinaryFile(const std::string& filename,
+                                                             std::vector<uint32_t>* damaged) {
+    std::vector<uint32_t> damaged_records;
+    FileVerificationResult result = scanRecordCrcs(filename, damaged_records, nullptr);
+    if (damaged) {
+        *damaged = damaged_records;
+    }
+    return result;
+}
+bool DatabaseManager::salvageImportFromBinaryFile(const std::string& filename, int user_id,
+                                                  std::vector<uint32_t>& damaged) {
+    std::vector<Game> games;
+    FileVerificationResult result = scanRecordCrcs(filename, damaged, &games);
+    if (result != FileVerificationResult::OK && result != FileVerificationResult::HASH_MISMATCH) {
+        if (result != FileVerificationResult::READ_ERROR) {
+            last_error_ = getVerificationErrorText(result);
+        }
+        return false;
+    }
+    for (auto& game : games) {
+        game.id = 0;
+        game.genre_id = 0;
+        game.user_id = user_id;
+        addGame(game);
+    }
+    return true;
+}
+std::vector<Game> DatabaseManager::readBinaryFile(const std::string& filename) {
+    std::vector<Game> games;
+    FileVerificationResult result = readBinaryFile(filename, games);
+    if (result != FileVerificationResult::OK && result != FileVerificationResult::HASH_MISMATCH) {
+        last_error_ = getVerificationErrorText(result);
+        games.clear();
+    }
+    return games;
+}
+bool DatabaseManager::lookupInBinaryFile(const std::string& filename, const std::string& name,
+                                         Game& game, uint32_t* record_no) {
+    try {
+        std::ifstream file(filename, std::ios::binary);
+        BinaryFileHeader header;
+        if (!file.is_open() || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            header.magic != FILE_MAGIC || header.version > FILE_VERSION) {
+            last_error_ = "Invalid file format";
+            return false;
+        }
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        BinaryGameRecord record;
+        if ((header.flags & FILE_FLAG_INDEX) && findFileSection(file, header, SECTION_NAME_INDEX, offset, size)) {
+            uint64_t key = HashUtils::fnv1a64(name.data(), std::min(name.size(), sizeof(record.name) - 1));
+            uint64_t low = 0;
+            uint64_t high = size / sizeof(BinaryNameIndexEntry);
+            uint64_t count = high;
+            BinaryNameIndexEntry entry;
+            while (low < high) {
+                uint64_t middle = low + (high - low) / 2;
+                if (!readIndexEntry(file, offset, middle, entry)) {
+                    return false;
+                }
+                if (entry.name_hash < key) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            for (uint64_t i = low; i < count; ++i) {
+                if (!readIndexEntry(file, offset, i, entry) || entry.name_hash != key) {
+                    break;
+                }
+                if (entry.record_no < header.record_count && readRecordAt(file, entry.record_no, record) &&
+                    recordString(record.name, sizeof(record.name)) == name) {
+                    game = decodeGameRecord(record);
+                    if (record_no) *record_no = entry.record_no;
+                    return true;
+                }
+            }
+            return false;
+        }
+        for (uint32_t i = 0; i < header.record_count; ++i) {
+            if (!readRecordAt(file, i, record)) {
+                break;
+            }
+            if (recordString(record.name, sizeof(record.name)) == name) {
+                game = decodeGameRecord(record);
+                if (record_no) *record_no = i;
+                return true;
+            }
+        }
+    } catch (const std::exception& e) {
+        last_error_ = std::string("Lookup error: ") + e.what();
+    }
+    return false;
+}
+bool DatabaseManager::lookupInBinaryFile(const std::string& filename, int id, Game& game, uint32_t* record_no) {
+    try {
+        std::ifstream file(filename, std::ios::binary);
+        BinaryFileHeader header;
+        if (!file.is_open() || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            header.magic != FILE_MAGIC || header.version > FILE_VERSION) {
             last_error_ = "Invalid file format";
-            file.close();
-            return games;
+            return false;
+        }
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        BinaryGameRecord record;
+        if ((header.flags & FILE_FLAG_INDEX) && findFileSection(file, header, SECTION_ID_INDEX, offset, size)) {
+            uint64_t low = 0;
+            uint64_t high = size / sizeof(BinaryIdIndexEntry);
+            BinaryIdIndexEntry entry;
+            while (low < high) {
+                uint64_t middle = low + (high - low) / 2;
+                if (!readIndexEntry(file, offset, middle, entry)) {
+                    return false;
+                }
+                if (entry.id == id) {
+                    if (entry.record_no >= header.record_count || !readRecordAt(file, entry.record_no, record)) {
+                        return false;
+                    }
+                    game = decodeGameRecord(record);
+                    if (record_no) *record_no = entry.record_no;
+                    return true;
+                }
+                if (entry.id < id) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            return false;
         }
         for (uint32_t i = 0; i < header.record_count; ++i) {
-            BinaryGameRecord record;
-            file.read(reinterpret_cast<char*>(&record), sizeof(record));
-            Game game;
-            game.id = record.id;
-            game.name = record.name;
-            game.disk_space = record.disk_space;
-            game.ram_usage = record.ram_usage;
-            game.vram_required = record.vram_required;
-            game.genre_id = record.genre_id;
-            game.genre = record.genre;
-            game.completed = record.completed != 0;
-            game.url = record.url;
-            game.user_id = record.user_id;
-            game.rating = record.rating;
-            game.is_favorite = record.is_favorite != 0;
-            game.is_installed = record.is_installed != 0;
-            game.notes = record.notes;
-            game.tags = record.tags;
-            games.push_back(game);
+            if (!readRecordAt(file, i, record)) {
+                break;
+            }
+            if (record.id == id) {
+                game = decodeGameRecord(record);
+                if (record_no) *record_no = i;
+                return true;
+            }
         }
-        file.close();
     } catch (const std::exception& e) {
-        last_error_ = std::string("Read binary file error: ") + e.what();
+        last_error_ = std::string("Lookup error: ") + e.what();
     }
-    return games;
+    return false;
 }
 std::string DatabaseManager::getLastError() const {
     return last_error_;
@@ -0,0 +1,91 @@
+#include "game_item_delegates.h"
+#include "game_table_model.h"
+#include "theme.h"
+#include <QApplication>
+#include <QPainter>
+#include <QStyle>
+#include <algorithm>
+namespace Temporium {
+static const QColor RATING_HIGH_COLOR("#4CAF50");
+static const QColor RATING_MID_COLOR("#FFC107");
+static const QColor RATING_LOW_COLOR("#F44336");
+static const QColor BADGE_TEXT_COLOR("#1e1e1e");
+static const QColor LINK_COLOR(ACCENT_COLOR);
+// Фон, рамка и выделение ячейки средствами стиля, без текста
+static void drawEmptyCell(QPainter* painter, QStyleOptionViewItem& opt) {
+    opt.text.clear();
+    const QWidget* widget = opt.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+}
+RatingDelegate::RatingDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+    font_.setBold(true);
+}
+void RatingDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    drawEmptyCell(painter, opt);
+    int rating = index.data(GameTableModel::ValueRole).toInt();
+    painter->save();
+    if (rating < 0) {
+        painter->setPen(opt.palette.color(QPalette::Disabled, QPalette::Text));
+        painter->drawText(opt.rect, Qt::AlignCenter, QStringLiteral("—"));
+        painter->restore();
+        return;
+    }
+    const QColor& color = rating >= 8 ? RATING_HIGH_COLOR : rating >= 5 ? RATING_MID_COLOR : RATING_LOW_COLOR;
+    QString text = QString::number(rating);
+    QFontMetrics metrics(font_);
+    int height = std::min(opt.rect.height() - 4, metrics.height() + 2);
+    int width = std::max(height, metrics.horizontalAdvance(text) + 10);
+    QRect badge(0, 0, width, height);
+    badge.moveCenter(opt.rect.center());
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(color);
+    painter->drawRoundedRect(badge, height / 2.0, height / 2.0);
+    painter->setFont(font_);
+    painter->setPen(BADGE_TEXT_COLOR);
+    painter->drawText(badge, Qt::AlignCenter, text);
+    painter->restore();
+}
+FlagDelegate::FlagDelegate(const QString& glyph, const QColor& color, int pointSize, QObject* parent)
+    : QStyledItemDelegate(parent)
+    , glyph_(glyph)
+    , color_(color)
+{
+    font_.setPointSize(pointSize);
+}
+void FlagDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    drawEmptyCell(painter, opt);
+    if (!index.data(GameTableModel::ValueRole).toBool()) return;
+    painter->save();
+    painter->setFont(font_);
+    painter->setPen(color_);
+    painter->drawText(opt.rect, Qt::AlignCenter, glyph_);
+    painter->restore();
+}
+LinkDelegate::LinkDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+    font_.setUnderline(true);
+}
+void LinkDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    drawEmptyCell(painter, opt);
+    if (index.data(GameTableModel::ValueRole).toString().isEmpty()) return;
+    static const QString linkText = QStringLiteral("🔗 Открыть");
+    QRect textRect = opt.rect.adjusted(4, 0, -4, 0);
+    painter->save();
+    painter->setFont(font_);
+    painter->setPen(LINK_COLOR);
+    painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter,
+                      QFontMetrics(font_).elidedText(linkText, Qt::ElideRight, textRect.width()));
+    painter->restore();
+}
+} // namespace Temporium
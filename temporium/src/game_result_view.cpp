@@ -0,0 +1,24 @@
+#include "game_result_view.h"
+#include <charconv>
+namespace Temporium {
+template <typename T>
+static T parseField(const pqxx::field& field, T fallback) {
+    if (field.is_null()) return fallback;
+    const char* begin = field.c_str();
+    const char* end = begin + field.size();
+    T value;
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    return ec == std::errc() && ptr == end ? value : fallback;
+}
+int fieldToInt(const pqxx::field& field, int fallback) {
+    return parseField<int>(field, fallback);
+}
+double fieldToDouble(const pqxx::field& field, double fallback) {
+    return parseField<double>(field, fallback);
+}
+bool fieldToBool(const pqxx::field& field, bool fallback) {
+    // Текстовый формат PostgreSQL: "t" / "f"
+    if (field.is_null() || field.size() == 0) return fallback;
+    return field.c_str()[0] == 't';
+}
+} // namespace Temporium
@@ -0,0 +1,222 @@
+#include "game_store.h"
+#include <algorithm>
+namespace Temporium {
+uint32_t StringDictionary::intern(std::string_view text) {
+    auto it = index_.find(text);
+    if (it != index_.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.emplace_back(text);
+    index_.emplace(strings_.back(), id);
+    return id;
+}
+void StringDictionary::clear() {
+    index_.clear();
+    strings_.clear();
+    strings_.shrink_to_fit();
+}
+size_t StringDictionary::memoryUsage() const {
+    size_t bytes = strings_.size() * sizeof(std::string);
+    for (const std::string& text : strings_) {
+        if (text.capacity() > 15) bytes += text.capacity() + 1;
+    }
+    // Узел хэш-таблицы: ключ, значение, указатель на следующий и хэш; плюс корзины
+    bytes += index_.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*));
+    bytes += index_.bucket_count() * sizeof(void*);
+    return bytes;
+}
+Game GameStore::GameView::toGame() const {
+    Game game;
+    game.id = id();
+    game.name = std::string(name());
+    game.disk_space = diskSpace();
+    game.ram_usage = ramUsage();
+    game.vram_required = vramRequired();
+    game.genre_id = genreId();
+    game.genre = std::string(genre());
+    game.completed = completed();
+    game.url = std::string(url());
+    game.user_id = userId();
+    game.rating = rating();
+    game.is_favorite = isFavorite();
+    game.is_installed = isInstalled();
+    game.has_notes = hasNotes();
+    game.notes_preview = std::string(notesPreview());
+    game.tags = std::string(tags());
+    return game;
+}
+int GameStore::rowOfGame(int gameId) const {
+    if (!rowIndexValid_) {
+        rowIndex_.clear();
+        rowIndex_.reserve(ids_.size());
+        for (size_t row = 0; row < ids_.size(); ++row) {
+            rowIndex_.emplace(ids_[row], static_cast<uint32_t>(row));
+        }
+        rowIndexValid_ = true;
+    }
+    auto it = rowIndex_.find(gameId);
+    return it == rowIndex_.end() ? -1 : static_cast<int>(it->second);
+}
+void GameStore::invalidateRowIndex() const {
+    rowIndexValid_ = false;
+    rowIndex_.clear();
+}
+void GameStore::reserve(size_t count) {
+    ids_.reserve(count);
+    userIds_.reserve(count);
+    genreIds_.reserve(count);
+    diskSpace_.reserve(count);
+    ramUsage_.reserve(count);
+    vramRequired_.reserve(count);
+    ratings_.reserve(count);
+    flags_.reserve(count);
+    genreRefs_.reserve(count);
+    tagRefs_.reserve(count);
+    names_.reserve(count);
+    urls_.reserve(count);
+    notesPreviews_.reserve(count);
+}
+GameStore::TextRef GameStore::addText(std::string_view text) {
+    TextRef ref{static_cast<uint32_t>(text_.size()), static_cast<uint32_t>(text.size())};
+    text_.append(text);
+    return ref;
+}
+GameStore::Fields GameStore::fieldsOf(const Game& game) {
+    Fields fields;
+    fields.id = game.id;
+    fields.user_id = game.user_id;
+    fields.genre_id = game.genre_id;
+    fields.disk_space = game.disk_space;
+    fields.ram_usage = game.ram_usage;
+    fields.vram_required = game.vram_required;
+    fields.rating = game.rating;
+    fields.completed = game.completed;
+    fields.is_favorite = game.is_favorite;
+    fields.is_installed = game.is_installed;
+    fields.has_notes = game.has_notes;
+    fields.genre = game.genre;
+    fields.tags = game.tags;
+    fields.name = game.name;
+    fields.url = game.url;
+    fields.notes_preview = game.notes_preview;
+    return fields;
+}
+void GameStore::insert(size_t row, const Fields& fields) {
+    // Добавление в конец не сдвигает строки: индекс дополняется в assign
+    if (row != size()) {
+        invalidateRowIndex();
+    }
+    // Место под строку во всех массивах, затем заполнение как при замене
+    ids_.insert(ids_.begin() + row, 0);
+    userIds_.insert(userIds_.begin() + row, 0);
+    genreIds_.insert(genreIds_.begin() + row, 0);
+    diskSpace_.insert(diskSpace_.begin() + row, 0);
+    ramUsage_.insert(ramUsage_.begin() + row, 0);
+    vramRequired_.insert(vramRequired_.begin() + row, 0);
+    ratings_.insert(ratings_.begin() + row, 0);
+    flags_.insert(flags_.begin() + row, 0);
+    genreRefs_.insert(genreRefs_.begin() + row, 0);
+    tagRefs_.insert(tagRefs_.begin() + row, 0);
+    names_.insert(names_.begin() + row, TextRef{0, 0});
+    urls_.insert(urls_.begin() + row, TextRef{0, 0});
+    notesPreviews_.insert(notesPreviews_.begin() + row, TextRef{0, 0});
+    assign(row, fields);
+}
+void GameStore::assign(size_t row, const Fields& fields) {
+    releaseText(row);
+    if (rowIndexValid_) {
+        auto it = rowIndex_.find(ids_[row]);
+        if (it != rowIndex_.end() && it->second == row) {
+            rowIndex_.erase(it);
+        }
+        rowIndex_[fields.id] = static_cast<uint32_t>(row);
+    }
+    ids_[row] = fields.id;
+    userIds_[row] = fields.user_id;
+    genreIds_[row] = fields.genre_id;
+    diskSpace_[row] = fields.disk_space;
+    ramUsage_[row] = fields.ram_usage;
+    vramRequired_[row] = fields.vram_required;
+    ratings_[row] = static_cast<int8_t>(fields.rating);
+    flags_[row] = (fields.completed ? FlagCompleted : 0) | (fields.is_favorite ? FlagFavorite : 0) |
+                  (fields.is_installed ? FlagInstalled : 0) | (fields.has_notes ? FlagHasNotes : 0);
+    genreRefs_[row] = genres_.intern(fields.genre);
+    tagRefs_[row] = tagSets_.intern(fields.tags);
+    names_[row] = addText(fields.name);
+    urls_[row] = addText(fields.url);
+    notesPreviews_[row] = addText(fields.notes_preview);
+    compactTextIfSparse();
+}
+void GameStore::releaseText(size_t row) {
+    deadText_ += names_[row].size + urls_[row].size + notesPreviews_[row].size;
+}
+void GameStore::erase(size_t row, size_t count) {
+    for (size_t i = row; i < row + count; ++i) {
+        releaseText(i);
+        if (rowIndexValid_) {
+            rowIndex_.erase(ids_[i]);
+        }
+    }
+    // Хвост можно снять из индекса по одной записи; удаление в середине сдвигает номера
+    if (row + count != size()) {
+        invalidateRowIndex();
+    }
+    auto eraseRange = [row, count](auto& values) {
+        values.erase(values.begin() + row, values.begin() + row + count);
+    };
+    eraseRange(ids_);
+    eraseRange(userIds_);
+    eraseRange(genreIds_);
+    eraseRange(diskSpace_);
+    eraseRange(ramUsage_);
+    eraseRange(vramRequired_);
+    eraseRange(ratings_);
+    eraseRange(flags_);
+    eraseRange(genreRefs_);
+    eraseRange(tagRefs_);
+    eraseRange(names_);
+    eraseRange(urls_);
+    eraseRange(notesPreviews_);
+    compactTextIfSparse();
+}
+void GameStore::compactTextIfSparse() {
+    // Буфер переписывается, когда мусор занимает больше половины
+    if (deadText_ <= text_.size() / 2) return;
+    std::string compacted;
+    compacted.reserve(text_.size() - deadText_);
+    auto move = [&](std::vector<TextRef>& refs) {
+        for (TextRef& ref : refs) {
+            uint32_t offset = static_cast<uint32_t>(compacted.size());
+            compacted.append(text(ref));
+            ref.offset = offset;
+        }
+    };
+    move(names_);
+    move(urls_);
+    move(notesPreviews_);
+    text_.swap(compacted);
+    deadText_ = 0;
+}
+void GameStore::clear() {
+    // Пустое хранилище вместо clear() массивов, чтобы вернуть память, а не только обнулить размер.
+    // Перемещение пустой строки оставляет ёмкость text_, поэтому буфер освобождается swap
+    *this = GameStore();
+    std::string().swap(text_);
+}
+template <typename T>
+static size_t capacityBytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+size_t GameStore::memoryUsage() const {
+    return sizeof(*this) +
+           capacityBytes(ids_) + capacityBytes(userIds_) + capacityBytes(genreIds_) +
+           capacityBytes(diskSpace_) + capacityBytes(ramUsage_) + capacityBytes(vramRequired_) +
+           capacityBytes(ratings_) + capacityBytes(flags_) +
+           capacityBytes(genreRefs_) + capacityBytes(tagRefs_) +
+           capacityBytes(names_) + capacityBytes(urls_) + capacityBytes(notesPreviews_) +
+           text_.capacity() + genres_.memoryUsage() + tagSets_.memoryUsage() +
+           rowIndex_.size() * (sizeof(int32_t) + sizeof(uint32_t) + 2 * sizeof(void*)) +
+           rowIndex_.bucket_count() * sizeof(void*);
+}
+} // namespace Temporium
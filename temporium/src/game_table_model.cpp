@@ -0,0 +1,464 @@
+#include "game_table_model.h"
+#include "theme.h"
+#include <QStringList>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <functional>
+#include <utility>
+namespace Temporium {
+static const QColor TAGS_COLOR(TEXT_SECONDARY);
+static const QColor COMPLETED_ROW_COLOR(30, 60, 30, 180);
+static const QColor FAVORITE_ROW_COLOR(60, 50, 20, 150);
+static QString toQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+// Названия в порядке ORDER BY g.name выборки: сравнение с учётом локали
+static int compareNames(std::string_view a, std::string_view b) {
+    return QString::localeAwareCompare(toQString(a), toQString(b));
+}
+GameTableModel::GameTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+    collator_.setNumericMode(true);
+    collator_.setCaseSensitivity(Qt::CaseInsensitive);
+}
+int GameTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(store_.size());
+}
+int GameTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+QVariant GameTableModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+    const GameStore::GameView game = store_.at(static_cast<size_t>(index.row()));
+    const int column = index.column();
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (column) {
+        case ColId:        return QString::number(game.id());
+        case ColName:      return game.hasNotes() ? toQString(game.name()) + " 📝" : toQString(game.name());
+        case ColDisk:      return QString::number(game.diskSpace(), 'f', 1);
+        case ColRam:       return QString::number(game.ramUsage(), 'f', 1);
+        case ColVram:      return QString::number(game.vramRequired(), 'f', 1);
+        case ColGenre:     return genreTexts_[game.genreKey()];
+        case ColCompleted: return game.completed() ? QStringLiteral("Да ✓") : QStringLiteral("Нет");
+        case ColTags:      return tagTexts_[game.tagsKey()];
+        }
+        break;
+    case Qt::ForegroundRole:
+        if (column == ColTags) return TAGS_COLOR;
+        break;
+    case Qt::BackgroundRole:
+        if (game.completed()) return COMPLETED_ROW_COLOR;
+        if (game.isFavorite()) return FAVORITE_ROW_COLOR;
+        break;
+    case ValueRole:
+        switch (column) {
+        case ColRating:    return game.rating();
+        case ColFavorite:  return game.isFavorite();
+        case ColInstalled: return game.isInstalled();
+        case ColUrl:       return toQString(game.url());
+        }
+        break;
+    case Qt::ToolTipRole:
+        if (column == ColName && game.hasNotes()) {
+            return "Есть заметки: " + toQString(game.notesPreview()) + "...";
+        }
+        if (column == ColUrl && !game.url().empty()) {
+            return toQString(game.url());
+        }
+        break;
+    case UrlRole:
+        if (column == ColUrl) return toQString(game.url());
+        break;
+    case NotesRole:
+        return toQString(game.notesPreview());
+    case GameIdRole:
+        return game.id();
+    }
+    return QVariant();
+}
+QVariant GameTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    static const QStringList headers = {
+        "ID", "Название", "Диск (ГБ)", "ОЗУ (ГБ)", "VRAM (ГБ)", "Жанр", "Пройдено", "Оценка", "★", "📥", "Теги", "Ссылка"
+    };
+    return section >= 0 && section < headers.size() ? headers[section] : QVariant();
+}
+bool GameTableModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && hasMore_ && dbManager_ != nullptr;
+}
+void GameTableModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent)) return;
+    bool ok = false;
+    GameResultView page = dbManager_->getGamesPage(userId_, filterActive_ ? &filter_ : nullptr, sort_, lastKey_, PAGE_SIZE, &ok);
+    // Ошибка — не конец данных: hasMore_ остаётся, следующая прокрутка повторит запрос
+    if (!ok) {
+        emit loadFailed(QString::fromStdString(dbManager_->getLastError()));
+        return;
+    }
+    appendPage(page);
+}
+// Значение столбца порядка (кроме названия); жанр и оценка — как в sortExpression на сервере
+static double sortValue(GameSort::Column column, double disk, double ram, double vram, int genreId, int rating) {
+    switch (column) {
+    case GameSort::ByDiskSpace:     return disk;
+    case GameSort::ByRamUsage:      return ram;
+    case GameSort::ByVramRequired:  return vram;
+    case GameSort::ByGenre:         return genreId;
+    case GameSort::ByRating:        return rating;
+    case GameSort::ByName:          break;
+    }
+    return 0;
+}
+static double sortValue(GameSort::Column column, const Game& game) {
+    return sortValue(column, game.disk_space, game.ram_usage, game.vram_required, game.genre_id, game.rating);
+}
+static double sortValue(GameSort::Column column, const GameStore::GameView& view) {
+    return sortValue(column, view.diskSpace(), view.ramUsage(), view.vramRequired(), view.genreId(), view.rating());
+}
+static double sortValue(GameSort::Column column, const GameResultView::Row& row) {
+    return sortValue(column, row.diskSpace(), row.ramUsage(), row.vramRequired(), row.genreId(), row.rating());
+}
+std::optional<GameSort> GameTableModel::serverSort(int column, Qt::SortOrder order) {
+    GameSort sort;
+    sort.descending = order == Qt::DescendingOrder;
+    switch (column) {
+    case ColName:   sort.column = GameSort::ByName; break;
+    case ColDisk:   sort.column = GameSort::ByDiskSpace; break;
+    case ColRam:    sort.column = GameSort::ByRamUsage; break;
+    case ColVram:   sort.column = GameSort::ByVramRequired; break;
+    case ColGenre:  sort.column = GameSort::ByGenre; break;
+    case ColRating: sort.column = GameSort::ByRating; break;
+    default:        return std::nullopt;
+    }
+    return sort;
+}
+bool GameTableModel::setSort(const GameSort& sort) {
+    if (sort == sort_) return true;
+    GameSort previous = sort_;
+    sort_ = sort;
+    if (dbManager_ == nullptr) return true;
+    GameFilter filter = filter_;
+    if (setSource(dbManager_, userId_, filterActive_ ? &filter : nullptr)) return true;
+    sort_ = previous;
+    return false;
+}
+static GameStore::Fields fieldsOfRow(const GameResultView::Row& row) {
+    GameStore::Fields fields;
+    fields.id = row.id();
+    fields.user_id = row.userId();
+    fields.genre_id = row.genreId();
+    fields.disk_space = row.diskSpace();
+    fields.ram_usage = row.ramUsage();
+    fields.vram_required = row.vramRequired();
+    fields.rating = row.rating();
+    fields.completed = row.completed();
+    fields.is_favorite = row.isFavorite();
+    fields.is_installed = row.isInstalled();
+    fields.has_notes = row.hasNotes();
+    fields.genre = row.genre();
+    fields.tags = row.tags();
+    fields.name = row.name();
+    fields.url = row.url();
+    fields.notes_preview = row.notesPreview();
+    return fields;
+}
+void GameTableModel::appendPage(const GameResultView& page) {
+    QElapsedTimer timer;
+    timer.start();
+    hasMore_ = page.size() == static_cast<size_t>(PAGE_SIZE);
+    if (page.empty()) return;
+    // Строка, вставленная upsertGame как «внутри загруженного», может прийти и в странице:
+    // порядок названий на клиенте (localeAwareCompare) и в сопоставлении БД иногда расходится
+    std::vector<size_t> fresh;
+    fresh.reserve(page.size());
+    for (size_t i = 0; i < page.size(); ++i) {
+        if (store_.rowOfGame(page[i].id()) < 0) fresh.push_back(i);
+    }
+    if (!fresh.empty()) {
+        int first = rowCount();
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(fresh.size()) - 1);
+        // Текст идёт из буфера результата сразу в хранилище. Без reserve на каждую
+        // страницу: точный reserve отменял бы геометрический рост массивов
+        for (size_t i : fresh) {
+            const GameResultView::Row row = page[i];
+            store_.append(fieldsOfRow(row));
+            nameSortKeys_.push_back(collator_.sortKey(toQString(row.name())));
+        }
+        syncDictionaries();
+        endInsertRows();
+    }
+    // Ключ — последняя строка страницы (позиция на сервере), даже если она пропущена
+    const GameResultView::Row last = page.back();
+    lastKey_.valid = true;
+    lastKey_.name = sort_.column == GameSort::ByName ? std::string(last.name()) : std::string();
+    lastKey_.value = sortValue(sort_.column, last);
+    lastKey_.id = last.id();
+    lastPageMicros_ = timer.nsecsElapsed() / 1000;
+}
+void GameTableModel::resetSource(DatabaseManager* dbManager, int userId, const GameFilter* filter) {
+    beginResetModel();
+    store_.clear();
+    nameSortKeys_.clear();
+    nameSortKeys_.shrink_to_fit();
+    genreTexts_.clear();
+    tagTexts_.clear();
+    genreSortKeys_.clear();
+    tagSortKeys_.clear();
+    dbManager_ = dbManager;
+    userId_ = userId;
+    filterActive_ = filter != nullptr;
+    filter_ = filter ? *filter : GameFilter();
+    lastKey_ = GamePageKey();
+    hasMore_ = false;
+    endResetModel();
+}
+bool GameTableModel::setSource(DatabaseManager* dbManager, int userId, const GameFilter* filter) {
+    // Первая страница читается до сброса, чтобы ошибка запроса не выглядела как пустой список
+    bool ok = false;
+    GameResultView firstPage = dbManager->getGamesPage(userId, filter, sort_, GamePageKey(), PAGE_SIZE, &ok);
+    if (!ok) {
+        // Строки другого пользователя оставлять нельзя
+        if (dbManager != dbManager_ || userId != userId_) clear();
+        emit loadFailed(QString::fromStdString(dbManager->getLastError()));
+        return false;
+    }
+    setSource(dbManager, userId, filter, firstPage);
+    return true;
+}
+void GameTableModel::setSource(DatabaseManager* dbManager, int userId, const GameFilter* filter,
+                               const GameResultView& firstPage) {
+    resetSource(dbManager, userId, filter);
+    appendPage(firstPage);
+}
+void GameTableModel::clear() {
+    resetSource(nullptr, 0, nullptr);
+}
+int GameTableModel::rowOfGame(int gameId) const {
+    return store_.rowOfGame(gameId);
+}
+Game GameTableModel::gameAt(int row) const {
+    return store_.at(static_cast<size_t>(row)).toGame();
+}
+void GameTableModel::syncDictionaries() {
+    // Текст и ключ сопоставления считаются один раз на жанр или набор тегов, а не на строку
+    const StringDictionary& genres = store_.genres();
+    for (size_t id = genreTexts_.size(); id < genres.size(); ++id) {
+        genreTexts_.push_back(toQString(genres.at(static_cast<uint32_t>(id))));
+        genreSortKeys_.push_back(collator_.sortKey(genreTexts_.back()));
+    }
+    const StringDictionary& tagSets = store_.tagSets();
+    for (size_t id = tagTexts_.size(); id < tagSets.size(); ++id) {
+        tagTexts_.push_back(toQString(tagSets.at(static_cast<uint32_t>(id))));
+        tagSortKeys_.push_back(collator_.sortKey(tagTexts_.back()));
+    }
+}
+int GameTableModel::compareSorted(std::string_view aName, double aValue, int aId,
+                                  std::string_view bName, double bValue, int bId) const {
+    int cmp = sort_.column == GameSort::ByName ? compareNames(aName, bName)
+                                               : (aValue < bValue ? -1 : (bValue < aValue ? 1 : 0));
+    if (cmp == 0) {
+        cmp = aId < bId ? -1 : (bId < aId ? 1 : 0);
+    }
+    return sort_.descending ? -cmp : cmp;
+}
+bool GameTableModel::isBeyondLoaded(const Game& game) const {
+    if (!hasMore_ || !lastKey_.valid) return false;
+    return compareSorted(lastKey_.name, lastKey_.value, lastKey_.id,
+                         game.name, sortValue(sort_.column, game), game.id) < 0;
+}
+bool GameTableModel::rowLess(size_t row, const Game& game) const {
+    const GameStore::GameView view = store_.at(row);
+    return compareSorted(view.name(), sortValue(sort_.column, view), view.id(),
+                         game.name, sortValue(sort_.column, game), game.id) < 0;
+}
+int GameTableModel::upsertGame(const Game& game) {
+    int row = rowOfGame(game.id);
+    if (row >= 0) {
+        size_t pos = static_cast<size_t>(row);
+        bool afterPrev = pos == 0 || rowLess(pos - 1, game);
+        bool beforeNext = pos + 1 == store_.size() || !rowLess(pos + 1, game);
+        if (afterPrev && beforeNext) {
+            store_.assign(pos, game);
+            nameSortKeys_[pos] = collator_.sortKey(QString::fromStdString(game.name));
+            syncDictionaries();
+            emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+            return row;
+        }
+        beginRemoveRows(QModelIndex(), row, row);
+        store_.erase(pos);
+        nameSortKeys_.erase(nameSortKeys_.begin() + row);
+        endRemoveRows();
+    }
+    if (isBeyondLoaded(game)) {
+        return -1;
+    }
+    // Двоичный поиск места в порядке sort_
+    size_t low = 0;
+    size_t high = store_.size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (rowLess(mid, game)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    int newRow = static_cast<int>(low);
+    beginInsertRows(QModelIndex(), newRow, newRow);
+    store_.insert(low, game);
+    nameSortKeys_.insert(nameSortKeys_.begin() + newRow, collator_.sortKey(QString::fromStdString(game.name)));
+    syncDictionaries();
+    endInsertRows();
+    return newRow;
+}
+bool GameTableModel::removeGame(int gameId) {
+    int row = rowOfGame(gameId);
+    if (row < 0) return false;
+    beginRemoveRows(QModelIndex(), row, row);
+    store_.erase(static_cast<size_t>(row));
+    nameSortKeys_.erase(nameSortKeys_.begin() + row);
+    endRemoveRows();
+    return true;
+}
+void GameTableModel::removeGames(const std::vector<int>& gameIds) {
+    std::vector<int> rows;
+    rows.reserve(gameIds.size());
+    for (int gameId : gameIds) {
+        int row = rowOfGame(gameId);
+        if (row >= 0) rows.push_back(row);
+    }
+    // С конца, чтобы номера ещё не удалённых строк не сдвигались
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    size_t i = 0;
+    while (i < rows.size()) {
+        int last = rows[i];
+        int first = last;
+        while (++i < rows.size() && rows[i] == first - 1) {
+            first = rows[i];
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        store_.erase(static_cast<size_t>(first), static_cast<size_t>(last - first + 1));
+        nameSortKeys_.erase(nameSortKeys_.begin() + first, nameSortKeys_.begin() + last + 1);
+        endRemoveRows();
+    }
+}
+void GameTableModel::updateGames(const GameResultView& updated) {
+    if (sort_.column != GameSort::ByName) {
+        // Пакетная правка может изменить столбец порядка (жанр): строки встают на новое место
+        for (size_t i = 0; i < updated.size(); ++i) {
+            const GameResultView::Row row = updated[i];
+            int pos = rowOfGame(row.id());
+            if (pos < 0) continue;
+            store_.assign(static_cast<size_t>(pos), fieldsOfRow(row));
+            upsertGame(store_.at(static_cast<size_t>(pos)).toGame());
+        }
+        return;
+    }
+    int firstRow = -1;
+    int lastRow = -1;
+    for (size_t i = 0; i < updated.size(); ++i) {
+        const GameResultView::Row row = updated[i];
+        int pos = rowOfGame(row.id());
+        if (pos < 0) continue;
+        store_.assign(static_cast<size_t>(pos), fieldsOfRow(row));
+        firstRow = firstRow < 0 ? pos : std::min(firstRow, pos);
+        lastRow = std::max(lastRow, pos);
+    }
+    if (firstRow < 0) return;
+    syncDictionaries();
+    emit dataChanged(index(firstRow, 0), index(lastRow, ColumnCount - 1));
+}
+template <typename T>
+static int compareValues(const T& a, const T& b) {
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+int GameTableModel::compareRows(int left, int right, int column) const {
+    const GameStore::GameView a = store_.at(static_cast<size_t>(left));
+    const GameStore::GameView b = store_.at(static_cast<size_t>(right));
+    switch (column) {
+    case ColId:        return compareValues(a.id(), b.id());
+    case ColName:      return nameSortKeys_[static_cast<size_t>(left)].compare(nameSortKeys_[static_cast<size_t>(right)]);
+    case ColDisk:      return compareValues(a.diskSpace(), b.diskSpace());
+    case ColRam:       return compareValues(a.ramUsage(), b.ramUsage());
+    case ColVram:      return compareValues(a.vramRequired(), b.vramRequired());
+    case ColGenre:
+        return a.genreKey() == b.genreKey() ? 0 : genreSortKeys_[a.genreKey()].compare(genreSortKeys_[b.genreKey()]);
+    case ColCompleted: return compareValues(a.completed(), b.completed());
+    case ColRating:    return compareValues(a.rating(), b.rating());
+    case ColFavorite:  return compareValues(a.isFavorite(), b.isFavorite());
+    case ColInstalled: return compareValues(a.isInstalled(), b.isInstalled());
+    case ColTags:
+        return a.tagsKey() == b.tagsKey() ? 0 : tagSortKeys_[a.tagsKey()].compare(tagSortKeys_[b.tagsKey()]);
+    case ColUrl:       return compareValues(a.url(), b.url());
+    }
+    return 0;
+}
+GameSortProxyModel::GameSortProxyModel(QObject* parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+void GameSortProxyModel::sort(int column, Qt::SortOrder order) {
+    if (column < 0) {
+        sortKeys_.clear();
+    } else {
+        sortKeys_.erase(std::remove_if(sortKeys_.begin(), sortKeys_.end(),
+                                       [column](const SortKey& key) { return key.column == column; }),
+                        sortKeys_.end());
+        sortKeys_.insert(sortKeys_.begin(), SortKey{column, order});
+        if (sortKeys_.size() > MAX_SORT_KEYS) {
+            sortKeys_.resize(MAX_SORT_KEYS);
+        }
+    }
+    QSortFilterProxyModel::sort(column, order);
+}
+void GameSortProxyModel::setSortKeys(const std::vector<SortKey>& keys) {
+    sortKeys_ = keys;
+    if (sortKeys_.size() > MAX_SORT_KEYS) {
+        sortKeys_.resize(MAX_SORT_KEYS);
+    }
+    if (sortKeys_.empty()) {
+        QSortFilterProxyModel::sort(-1);
+    } else {
+        QSortFilterProxyModel::sort(sortKeys_.front().column, sortKeys_.front().order);
+    }
+}
+QString GameSortProxyModel::sortKeysToString() const {
+    QStringList parts;
+    for (const SortKey& key : sortKeys_) {
+        parts << QString("%1:%2").arg(key.column).arg(key.order == Qt::AscendingOrder ? 0 : 1);
+    }
+    return parts.join(';');
+}
+std::vector<GameSortProxyModel::SortKey> GameSortProxyModel::sortKeysFromString(const QString& text) {
+    std::vector<SortKey> keys;
+    for (const QString& part : text.split(';', Qt::SkipEmptyParts)) {
+        QStringList fields = part.split(':');
+        bool columnOk = false;
+        int column = fields.value(0).toInt(&columnOk);
+        if (!columnOk || column < 0 || column >= GameTableModel::ColumnCount || fields.size() != 2) {
+            continue;
+        }
+        keys.push_back(SortKey{column, fields[1] == "1" ? Qt::DescendingOrder : Qt::AscendingOrder});
+    }
+    return keys;
+}
+bool GameSortProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const {
+    const GameTableModel* model = static_cast<const GameTableModel*>(sourceModel());
+    // Порядок первичного ключа Qt применяет сам; вторичный ключ с иным порядком инвертируется
+    const Qt::SortOrder primaryOrder = sortOrder();
+    for (const SortKey& key : sortKeys_) {
+        int cmp = model->compareRows(left.row(), right.row(), key.column);
+        if (cmp != 0) {
+            return key.order == primaryOrder ? cmp < 0 : cmp > 0;
+        }
+    }
+    int cmp = model->compareRows(left.row(), right.row(), GameTableModel::ColId);
+    return primaryOrder == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
+}
+} // namespace Temporium
@@ -1,4 +1,5 @@
 #include "mainwindow.h"
+#include "theme.h"
 #include <QApplication>
 #include <QStyle>
 #include <QScreen>
@@ -6,17 +7,33 @@
 #include <QInputDialog>
 #include <QDir>
 #include <QFileInfo>
+#include <QSignalBlocker>
+#include <QtConcurrent>
+#include <QtAlgorithms>
 #include <algorithm>
+#include <memory>
 namespace Temporium {
-const QString DARK_BG = "#303030";
-const QString DARK_LIGHTER = "#404040";
-const QString DARK_BORDER = "#505050";
-const QString BORDER_COLOR = "#505050";
-const QString ACCENT_COLOR = "#03fce8";
-const QString ACCENT_DARKER = "#02d4c4";
-const QString TEXT_COLOR = "#ffffff";
-const QString TEXT_PRIMARY = "#ffffff";
-const QString TEXT_SECONDARY = "#b0b0b0";
+// Исходный текст пункта комбобокса, к которому дописывается счётчик фасеты
+static constexpr int FACET_BASE_TEXT_ROLE = Qt::UserRole + 1;
+static void setComboFacetCount(QComboBox* combo, int index, int count) {
+    QString base = combo->itemData(index, FACET_BASE_TEXT_ROLE).toString();
+    if (base.isEmpty()) {
+        base = combo->itemText(index);
+        combo->setItemData(index, base, FACET_BASE_TEXT_ROLE);
+    }
+    combo->setItemText(index, QString("%1 (%2)").arg(base).arg(count));
+}
+template <size_t N>
+static QString facetHistogramText(const std::array<double, N>& edges, const std::array<int, N + 1>& counts) {
+    QStringList parts;
+    for (size_t i = 0; i <= N; ++i) {
+        QString range = i == 0 ? QString("<%1").arg(edges[0])
+                      : i == N ? QString("≥%1").arg(edges[N - 1])
+                               : QString("%1–%2").arg(edges[i - 1]).arg(edges[i]);
+        parts << QString("%1: %2").arg(range).arg(counts[i]);
+    }
+    return parts.join(" · ");
+}
 static void setupSpinBox(QDoubleSpinBox* spinBox, double min, double max, double defaultVal = 0) {
     spinBox->setDecimals(1);
     spinBox->setRange(-99999, 99999);
@@ -33,6 +50,7 @@ MainWindow::MainWindow(QWidget *parent)
     , lastClickedRow_(-1)
     , settings_("NSTU", "Temporium")
 {
+    filterPool_.setMaxThreadCount(1);
     setWindowTitle("Temporium - СУБД Компьютерные Игры");
     setMinimumSize(1200, 700);
     resize(1400, 800);
@@ -50,7 +68,12 @@ MainWindow::MainWindow(QWidget *parent)
     showLoginPage();
     statusBar()->showMessage("Добро пожаловать в Temporium!");
 }
-MainWindow::~MainWindow() {}
+MainWindow::~MainWindow() {
+    ++filterGeneration_;
+    ++facetGeneration_;
+    filterDb_.cancelQuery();
+    filterPool_.waitForDone();
+}
 void MainWindow::applyDarkTheme() {
     QString styleSheet = QString(R"(
         QMainWindow, QWidget {
@@ -134,7 +157,7 @@ void MainWindow::applyDarkTheme() {
             selection-background-color: %5;
             selection-color: #000000;
         }
-        QTableWidget {
+        QTableView {
             background-color: %3;
             color: %2;
             gridline-color: %4;
@@ -143,11 +166,11 @@ void MainWindow::applyDarkTheme() {
             selection-background-color: %5;
             selection-color: #000000;
         }
-        QTableWidget::item {
+        QTableView::item {
             padding: 5px;
             border-right: 1px solid %4;
         }
-        QTableWidget::item:selected {
+        QTableView::item:selected {
             background-color: %5;
             color: #000000;
         }
@@ -266,6 +289,18 @@ bool MainWindow::eventFilter(QObject* obj, QEvent* event) {
             }
         }
     }
+    if (event->type() == QEvent::Paint && obj == gamesTable_->viewport()) {
+        // Кадры таблицы в секунду для оверлея; пауза дольше двух секунд начинает новое окно
+        qint64 elapsed = tableFpsTimer_.isValid() ? tableFpsTimer_.elapsed() : -1;
+        if (elapsed < 0 || elapsed > 2000) {
+            tableFpsTimer_.start();
+            tableFrames_ = 0;
+        } else if (++tableFrames_, elapsed >= 1000) {
+            tableFps_ = tableFrames_ * 1000.0 / tableFpsTimer_.restart();
+            tableFrames_ = 0;
+            updateDebugOverlay();
+        }
+    }
     return QMainWindow::eventFilter(obj, event);
 }
 void MainWindow::connectToDatabase() {
@@ -290,6 +325,8 @@ void MainWindow::connectToDatabase() {
 "
                     "./run.sh db-start")
                 .arg(QString::fromStdString(dbManager_.getLastError())));
+    } else if (!filterDb_.connectSecondary(dbManager_)) {
+        statusBar()->showMessage("Фоновое подключение недоступно, фильтрация будет синхронной");
     }
 }
 void MainWindow::saveLastUsername() {
@@ -390,6 +427,10 @@ void MainWindow::setupMainPage() {
     filterGroupBox_ = new QGroupBox("Фильтры");
     QVBoxLayout* filterLayout = new QVBoxLayout(filterGroupBox_);
     filterLayout->setSpacing(8);
+    filterNameEdit_ = new QLineEdit();
+    filterNameEdit_->setPlaceholderText("🔍 Поиск по названию...");
+    filterNameEdit_->setClearButtonEnabled(true);
+    filterLayout->addWidget(filterNameEdit_);
     QHBoxLayout* completedLayout = new QHBoxLayout();
     filterCompletedCheck_ = new QCheckBox("Статус:");
     filterCompletedCombo_ = new QComboBox();
@@ -424,6 +465,8 @@ void MainWindow::setupMainPage() {
     diskMaxLayout->addWidget(filterDiskMaxCheck_);
     diskMaxLayout->addWidget(filterDiskMaxSpin_, 1);
     filterLayout->addLayout(diskMaxLayout);
+    diskFacetLabel_ = new QLabel();
+    filterLayout->addWidget(diskFacetLabel_);
     filterLayout->addWidget(new QLabel("ОЗУ (ГБ):"));
     QHBoxLayout* ramMinLayout = new QHBoxLayout();
     filterRamMinCheck_ = new QCheckBox("Мин:");
@@ -441,6 +484,8 @@ void MainWindow::setupMainPage() {
     ramMaxLayout->addWidget(filterRamMaxCheck_);
     ramMaxLayout->addWidget(filterRamMaxSpin_, 1);
     filterLayout->addLayout(ramMaxLayout);
+    ramFacetLabel_ = new QLabel();
+    filterLayout->addWidget(ramFacetLabel_);
     filterLayout->addWidget(new QLabel("Видеопамять (ГБ):"));
     QHBoxLayout* vramMinLayout = new QHBoxLayout();
     filterVramMinCheck_ = new QCheckBox("Мин:");
@@ -458,6 +503,12 @@ void MainWindow::setupMainPage() {
     vramMaxLayout->addWidget(filterVramMaxCheck_);
     vramMaxLayout->addWidget(filterVramMaxSpin_, 1);
     filterLayout->addLayout(vramMaxLayout);
+    vramFacetLabel_ = new QLabel();
+    filterLayout->addWidget(vramFacetLabel_);
+    for (QLabel* facetLabel : {diskFacetLabel_, ramFacetLabel_, vramFacetLabel_}) {
+        facetLabel->setWordWrap(true);
+        facetLabel->setStyleSheet(QString("color: %1; font-size: 8pt;").arg(TEXT_SECONDARY));
+    }
     filterLayout->addWidget(new QLabel(""));
     QHBoxLayout* tagLayout = new QHBoxLayout();
     filterTagCheck_ = new QCheckBox("Тег:");
@@ -500,18 +551,35 @@ void MainWindow::setupMainPage() {
     filterButtonLayout->addWidget(applyFilterButton_);
     filterButtonLayout->addWidget(resetFilterButton_);
     filterLayout->addLayout(filterButtonLayout);
+    filterDebounce_ = new QTimer(this);
+    filterDebounce_->setSingleShot(true);
+    filterDebounce_->setInterval(FILTER_DEBOUNCE_MS);
+    debugOverlayLabel_ = new QLabel();
+    debugOverlayLabel_->setStyleSheet(QString("color: %1;").arg(TEXT_SECONDARY));
+    statusBar()->addPermanentWidget(debugOverlayLabel_);
+    debugOverlayLabel_->setVisible(qEnvironmentVariableIsSet("TEMPORIUM_DEBUG_OVERLAY"));
+    writeBehindTimer_ = new QTimer(this);
+    writeBehindTimer_->setSingleShot(true);
+    writeBehindTimer_->setInterval(WRITE_BEHIND_DELAY_MS);
+    pendingWritesLabel_ = new QLabel();
+    pendingWritesLabel_->setStyleSheet("color: #FFD700;");
+    pendingWritesLabel_->setVisible(false);
+    statusBar()->addPermanentWidget(pendingWritesLabel_);
+    gamesCountLabel_ = new QLabel();
+    statusBar()->addPermanentWidget(gamesCountLabel_);
     leftLayout->addWidget(filterGroupBox_);
     leftLayout->addStretch();
     QWidget* rightPanel = new QWidget();
     QVBoxLayout* rightLayout = new QVBoxLayout(rightPanel);
     rightLayout->setContentsMargins(0, 0, 0, 0);
-    gamesTable_ = new QTableWidget();
-    gamesTable_->setColumnCount(12);
-    gamesTable_->setHorizontalHeaderLabels({
-        "ID", "Название", "Диск (ГБ)", "ОЗУ (ГБ)", "VRAM (ГБ)", "Жанр", "Пройдено", "Оценка", "★", "📥", "Теги", "Ссылка"
-    });
+    gamesModel_ = new GameTableModel(this);
+    gamesProxy_ = new GameSortProxyModel(this);
+    gamesProxy_->setSourceModel(gamesModel_);
+    gamesTable_ = new QTableView();
+    gamesTable_->setModel(gamesProxy_);
     gamesTable_->setSelectionBehavior(QAbstractItemView::SelectRows);
-    gamesTable_->setSelectionMode(QAbstractItemView::SingleSelection);
+    gamesTable_->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    gamesTable_->setContextMenuPolicy(Qt::CustomContextMenu);
     gamesTable_->setEditTriggers(QAbstractItemView::NoEditTriggers);
     gamesTable_->setShowGrid(true);
     gamesTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
@@ -519,10 +587,21 @@ void MainWindow::setupMainPage() {
     gamesTable_->horizontalHeader()->setMinimumSectionSize(40);
     resetTableColumnWidths();
     gamesTable_->verticalHeader()->setVisible(false);
+    restoreTableSort();
+    gamesTable_->setSortingEnabled(true);
     gamesTable_->setAlternatingRowColors(true);
     gamesTable_->setStyleSheet(QString(
-        "QTableWidget { alternate-background-color: %1; }"
+        "QTableView { alternate-background-color: %1; }"
     ).arg(DARK_LIGHTER));
+    gamesTable_->setItemDelegateForColumn(GameTableModel::ColRating, new RatingDelegate(gamesTable_));
+    gamesTable_->setItemDelegateForColumn(GameTableModel::ColFavorite,
+        new FlagDelegate(QStringLiteral("★"), QColor("#FFD700"), 14, gamesTable_));
+    gamesTable_->setItemDelegateForColumn(GameTableModel::ColInstalled,
+        new FlagDelegate(QStringLiteral("📥"), QColor("#2196F3"), 12, gamesTable_));
+    gamesTable_->setItemDelegateForColumn(GameTableModel::ColUrl, new LinkDelegate(gamesTable_));
+    if (!debugOverlayLabel_->isHidden()) {
+        gamesTable_->viewport()->installEventFilter(this);
+    }
     QHBoxLayout* controlLayout = new QHBoxLayout();
     addButton_ = new QPushButton("➕ Добавить");
     editButton_ = new QPushButton("✏️ Редактировать");
@@ -621,7 +700,9 @@ void MainWindow::setupMenuBar() {
     QMenu* dataMenu = menuBar->addMenu("Данные");
     exportAction_ = dataMenu->addAction("Экспорт в файл...");
     exportFilteredAction_ = dataMenu->addAction("Экспорт с фильтром...");
+    exportDeltaAction_ = dataMenu->addAction("Экспорт изменений (дельта)...");
     importAction_ = dataMenu->addAction("Импорт из файла...");
+    importChainAction_ = dataMenu->addAction("Восстановление: база + дельты...");
     dataMenu->addSeparator();
     viewExportedAction_ = dataMenu->addAction("Просмотр экспортированного файла...");
     adminMenu_ = menuBar->addMenu("Администрирование");
@@ -665,6 +746,22 @@ void MainWindow::setupConnections() {
     connect(saveNotesButton_, &QPushButton::clicked, this, &MainWindow::onSaveNotes);
     connect(applyFilterButton_, &QPushButton::clicked, this, &MainWindow::onApplyFilter);
     connect(resetFilterButton_, &QPushButton::clicked, this, &MainWindow::onResetFilter);
+    for (QCheckBox* check : {filterCompletedCheck_, filterGenreCheck_, filterDiskMinCheck_, filterDiskMaxCheck_,
+                             filterRamMinCheck_, filterRamMaxCheck_, filterVramMinCheck_, filterVramMaxCheck_,
+                             filterTagCheck_, filterFavoriteCheck_, filterInstalledCheck_, filterRatingCheck_}) {
+        connect(check, &QCheckBox::toggled, this, &MainWindow::onFilterChanged);
+    }
+    for (QComboBox* combo : {filterCompletedCombo_, filterGenreCombo_, filterTagCombo_, filterFavoriteCombo_,
+                             filterInstalledCombo_, filterRatingCombo_}) {
+        connect(combo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onFilterChanged);
+    }
+    for (QDoubleSpinBox* spin : {filterDiskMinSpin_, filterDiskMaxSpin_, filterRamMinSpin_, filterRamMaxSpin_,
+                                 filterVramMinSpin_, filterVramMaxSpin_}) {
+        connect(spin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &MainWindow::onFilterChanged);
+    }
+    connect(filterNameEdit_, &QLineEdit::textChanged, this, &MainWindow::onFilterChanged);
+    connect(filterDebounce_, &QTimer::timeout, this, &MainWindow::startFilterQuery);
+    connect(writeBehindTimer_, &QTimer::timeout, this, &MainWindow::flushPendingWrites);
     connect(loginAction_, &QAction::triggered, this, &MainWindow::showLoginPage);
     connect(logoutAction_, &QAction::triggered, this, &MainWindow::onLogout);
     connect(exitAction_, &QAction::triggered, this, &QWidget::close);
@@ -673,26 +770,40 @@ void MainWindow::setupConnections() {
     connect(deleteAction_, &QAction::triggered, this, &MainWindow::onDeleteGame);
     connect(exportAction_, &QAction::triggered, this, &MainWindow::onExportToFile);
     connect(exportFilteredAction_, &QAction::triggered, this, &MainWindow::onExportFilteredToFile);
+    connect(exportDeltaAction_, &QAction::triggered, this, &MainWindow::onExportDeltaToFile);
     connect(importAction_, &QAction::triggered, this, &MainWindow::onImportFromFile);
+    connect(importChainAction_, &QAction::triggered, this, &MainWindow::onImportDeltaChain);
     connect(viewExportedAction_, &QAction::triggered, this, &MainWindow::onViewExportedFile);
     connect(aboutAction_, &QAction::triggered, this, &MainWindow::onAbout);
     connect(adminAction_, &QAction::triggered, this, &MainWindow::onAdminPanel);
-    connect(gamesTable_, &QTableWidget::itemSelectionChanged, this, &MainWindow::onTableSelectionChanged);
-    connect(gamesTable_, &QTableWidget::cellClicked, this, &MainWindow::onTableCellClicked);
-    connect(gamesTable_, &QTableWidget::cellDoubleClicked, this, &MainWindow::onTableCellDoubleClicked);
-}
-void MainWindow::onTableCellClicked(int row, int column) {
-    if (column == 11) {
-        QTableWidgetItem* item = gamesTable_->item(row, 11);
-        if (item) {
-            QString url = item->data(Qt::UserRole).toString();
-            if (!url.isEmpty()) {
-                if (!url.startsWith("http://") && !url.startsWith("https://")) {
-                    url = "https://" + url;
-                }
-                QDesktopServices::openUrl(QUrl(url));
-                return;
+    connect(gamesTable_->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::onTableSelectionChanged);
+    connect(gamesModel_, &GameTableModel::loadFailed, this, [this](const QString& error) {
+        statusBar()->showMessage(QString("Не удалось загрузить игры: %1").arg(error), 5000);
+    });
+    connect(gamesTable_, &QTableView::clicked, this, &MainWindow::onTableCellClicked);
+    connect(gamesTable_, &QTableView::doubleClicked, this, &MainWindow::onTableCellDoubleClicked);
+    connect(gamesTable_, &QWidget::customContextMenuRequested, this, &MainWindow::onGamesContextMenu);
+    connect(gamesTable_->horizontalHeader(), &QHeaderView::sortIndicatorChanged, this, [this]() {
+        settings_.setValue("gamesTable/sort", gamesProxy_->sortKeysToString());
+        applyServerSort();
+    });
+}
+void MainWindow::onTableCellClicked(const QModelIndex& index) {
+    int row = index.row();
+    if (index.column() == GameTableModel::ColFavorite || index.column() == GameTableModel::ColInstalled ||
+        index.column() == GameTableModel::ColCompleted) {
+        toggleGameFlag(index);
+        updateButtonStates();
+        return;
+    }
+    if (index.column() == GameTableModel::ColUrl) {
+        QString url = index.data(GameTableModel::UrlRole).toString();
+        if (!url.isEmpty()) {
+            if (!url.startsWith("http://") && !url.startsWith("https://")) {
+                url = "https://" + url;
             }
+            QDesktopServices::openUrl(QUrl(url));
+            return;
         }
     }
     if (row == lastClickedRow_ && gamesTable_->selectionModel()->isRowSelected(row, QModelIndex())) {
@@ -703,21 +814,127 @@ void MainWindow::onTableCellClicked(int row, int column) {
     }
     updateButtonStates();
 }
-void MainWindow::onTableCellDoubleClicked(int row, int column) {
-    if (column == 11) {
-        QTableWidgetItem* item = gamesTable_->item(row, column);
-        if (item && !item->text().isEmpty()) {
-            QString url = item->data(Qt::UserRole).toString();
-            if (!url.isEmpty()) {
-                QDesktopServices::openUrl(QUrl(url));
-                return;
-            }
+void MainWindow::onTableCellDoubleClicked(const QModelIndex& index) {
+    if (index.column() == GameTableModel::ColUrl) {
+        QString url = index.data(GameTableModel::UrlRole).toString();
+        if (!url.isEmpty()) {
+            QDesktopServices::openUrl(QUrl(url));
+            return;
         }
     }
     onEditGame();
 }
+std::vector<int> MainWindow::selectedGameIds() const {
+    std::vector<int> ids;
+    for (const QModelIndex& index : gamesTable_->selectionModel()->selectedRows()) {
+        int row = gamesProxy_->mapToSource(index).row();
+        if (row >= 0) {
+            ids.push_back(gamesModel_->store().at(static_cast<size_t>(row)).id());
+        }
+    }
+    return ids;
+}
+void MainWindow::onGamesContextMenu(const QPoint& pos) {
+    std::vector<int> ids = selectedGameIds();
+    if (ids.empty()) return;
+    int userId = currentUser_.id;
+    QMenu menu(this);
+    menu.addAction(QString("Удалить выбранные (%1)").arg(ids.size()), this, [this, ids]() {
+        deleteSelectedGames(ids);
+    });
+    QMenu* genreMenu = menu.addMenu("Жанр");
+    for (const Genre& genre : genres_) {
+        int genreId = genre.id;
+        genreMenu->addAction(QString::fromStdString(genre.name), this, [this, ids, userId, genreId]() {
+            applyBulkUpdate([&](GameResultView* updated) {
+                return dbManager_.setGamesGenre(ids, userId, genreId, updated);
+            }, RefreshFacets);
+        });
+    }
+    QMenu* addTagMenu = menu.addMenu("Добавить тег");
+    QMenu* removeTagMenu = menu.addMenu("Убрать тег");
+    for (const Tag& tag : userTags_) {
+        int tagId = tag.id;
+        addTagMenu->addAction(QString::fromStdString(tag.name), this, [this, ids, userId, tagId]() {
+            applyBulkUpdate([&](GameResultView* updated) {
+                return dbManager_.addTagToGames(ids, userId, tagId, updated);
+            }, RefreshFacets);
+        });
+        removeTagMenu->addAction(QString::fromStdString(tag.name), this, [this, ids, userId, tagId]() {
+            applyBulkUpdate([&](GameResultView* updated) {
+                return dbManager_.removeTagFromGames(ids, userId, tagId, updated);
+            }, RefreshFacets);
+        });
+    }
+    addTagMenu->setEnabled(!userTags_.empty());
+    removeTagMenu->setEnabled(!userTags_.empty());
+    QMenu* flagMenu = menu.addMenu("Отметить");
+    const struct {
+        const char* text;
+        DatabaseManager::GameFlag flag;
+        bool value;
+    } flagActions[] = {
+        {"★ В избранное", DatabaseManager::GameFlag::Favorite, true},
+        {"Убрать из избранного", DatabaseManager::GameFlag::Favorite, false},
+        {"📥 Установлено", DatabaseManager::GameFlag::Installed, true},
+        {"Не установлено", DatabaseManager::GameFlag::Installed, false},
+        {"✓ Пройдено", DatabaseManager::GameFlag::Completed, true},
+        {"Не пройдено", DatabaseManager::GameFlag::Completed, false}
+    };
+    for (const auto& action : flagActions) {
+        DatabaseManager::GameFlag flag = action.flag;
+        bool value = action.value;
+        flagMenu->addAction(QString::fromUtf8(action.text), this, [this, ids, userId, flag, value]() {
+            applyBulkUpdate([&](GameResultView* updated) {
+                return dbManager_.setGamesFlag(ids, userId, flag, value, updated);
+            }, RefreshStats | RefreshFacets);
+        });
+    }
+    menu.exec(gamesTable_->viewport()->mapToGlobal(pos));
+}
+void MainWindow::deleteSelectedGames(const std::vector<int>& gameIds) {
+    QMessageBox::StandardButton reply = QMessageBox::question(this, "Подтверждение",
+        QString("Удалить выбранные игры (%1)?").arg(gameIds.size()),
+        QMessageBox::Yes | QMessageBox::No);
+    if (reply != QMessageBox::Yes) return;
+    uint64_t commitsBefore = dbManager_.commitCount();
+    if (dbManager_.deleteGames(gameIds, currentUser_.id)) {
+        noteEditCommits(commitsBefore);
+        lastClickedRow_ = -1;
+        gamesModel_->removeGames(gameIds);
+        gamesTable_->clearSelection();
+        updateButtonStates();
+        scheduleRefresh(RefreshCount | RefreshStats | RefreshFacets);
+        statusBar()->showMessage(QString("Удалено игр: %1").arg(gameIds.size()));
+    } else {
+        QMessageBox::critical(this, "Ошибка", 
+            QString("Не удалось удалить игры: %1")
+                .arg(QString::fromStdString(dbManager_.getLastError())));
+    }
+}
+void MainWindow::applyBulkUpdate(const std::function<bool(GameResultView*)>& update, unsigned refresh) {
+    // Отложенные флаги пишутся раньше, иначе запись очереди затрёт пакетное значение.
+    // Не записались — пакетная операция не выполняется (ошибка уже в строке состояния)
+    if (!flushPendingWrites()) return;
+    GameResultView updated;
+    uint64_t commitsBefore = dbManager_.commitCount();
+    if (!update(&updated)) {
+        QMessageBox::critical(this, "Ошибка", 
+            QString("Не удалось изменить игры: %1")
+                .arg(QString::fromStdString(dbManager_.getLastError())));
+        return;
+    }
+    noteEditCommits(commitsBefore);
+    if (filterActive_) {
+        refresh |= RefreshTable | RefreshCount;
+    } else {
+        gamesModel_->updateGames(updated);
+    }
+    scheduleRefresh(refresh);
+    statusBar()->showMessage(QString("Изменено игр: %1").arg(updated.size()));
+}
 void MainWindow::onToggleNotesPanel() {
-    int row = gamesTable_->currentRow();
+    int row = currentGameRow();
     if (row < 0) {
         notesPanel_->setVisible(false);
         notesButton_->setChecked(false);
@@ -726,19 +943,122 @@ void MainWindow::onToggleNotesPanel() {
     bool showPanel = notesButton_->isChecked();
     notesPanel_->setVisible(showPanel);
     if (showPanel) {
-        QTableWidgetItem* idItem = gamesTable_->item(row, 0);
-        if (idItem) {
-            int gameId = idItem->text().toInt();
-            QString gameName = gamesTable_->item(row, 1)->text();
-            QString notes = idItem->data(Qt::UserRole + 1).toString();
-            currentNotesGameId_ = gameId;
-            notesPanelTitle_->setText(QString("📝 Заметки: %1").arg(gameName));
-            notesPanelEdit_->setPlainText(notes);
-            notesPanelEdit_->setFocus();
-        }
+        showNotesInPanel(gamesModel_->gameAt(row));
+        notesPanelEdit_->setFocus();
     } else {
         currentNotesGameId_ = -1;
+        notesWaitingGameId_ = -1;
+    }
+}
+void MainWindow::showNotesInPanel(const Game& game) {
+    currentNotesGameId_ = game.id;
+    notesPanelTitle_->setText(QString("📝 Заметки: %1").arg(QString::fromStdString(game.name)));
+    const std::string* notes = game.has_notes ? cachedNotes(game.id) : nullptr;
+    if (!game.has_notes || notes) {
+        notesWaitingGameId_ = -1;
+        notesPanelEdit_->setPlainText(notes ? QString::fromStdString(*notes) : QString());
+        notesPanelEdit_->setEnabled(true);
+        saveNotesButton_->setEnabled(true);
+        return;
+    }
+    // Пока текст не пришёл, редактор закрыт: сохранение пустого поля стёрло бы заметки
+    notesWaitingGameId_ = game.id;
+    notesPanelEdit_->setPlainText("Загрузка...");
+    notesPanelEdit_->setEnabled(false);
+    saveNotesButton_->setEnabled(false);
+    prefetchNotes(game);
+}
+void MainWindow::prefetchNotes(const Game& game) {
+    if (!game.has_notes || dbManager_.pendingGameNotes(game.id) || notesCacheIndex_.count(game.id) ||
+        notesInFlight_.count(game.id)) {
+        return;
+    }
+    int gameId = game.id;
+    int userId = currentUser_.id;
+    if (!filterDb_.isConnected()) {
+        bool ok = false;
+        std::string notes = dbManager_.getGameNotes(gameId, userId, &ok);
+        onNotesLoaded(gameId, ok ? std::optional<std::string>(std::move(notes)) : std::nullopt);
+        return;
+    }
+    notesInFlight_.insert(gameId);
+    DatabaseManager* db = &filterDb_;
+    auto* watcher = new QFutureWatcher<std::optional<std::string>>(this);
+    connect(watcher, &QFutureWatcher<std::optional<std::string>>::finished, this, [this, watcher, gameId, userId]() {
+        watcher->deleteLater();
+        notesInFlight_.erase(gameId);
+        // После выхода из учётной записи ответ для прежнего пользователя не нужен
+        if (userId == currentUser_.id) {
+            onNotesLoaded(gameId, watcher->result());
+        }
+    });
+    watcher->setFuture(QtConcurrent::run(&filterPool_, [db, gameId, userId]() {
+        std::optional<std::string> result;
+        bool ok = false;
+        std::string notes = db->getGameNotes(gameId, userId, &ok);
+        if (!ok) {
+            notes = db->getGameNotes(gameId, userId, &ok);
+        }
+        if (ok) result = std::move(notes);
+        return result;
+    }));
+}
+void MainWindow::onNotesLoaded(int gameId, const std::optional<std::string>& notes) {
+    // Ответ, отправленный до сохранения заметок в очередь, не должен затереть их в кэше
+    if (notes && !dbManager_.pendingGameNotes(gameId)) {
+        cacheNotes(gameId, *notes);
+    }
+    if (gameId != notesWaitingGameId_) return;
+    notesWaitingGameId_ = -1;
+    if (!notes) {
+        notesPanelEdit_->setPlainText(QString());
+        statusBar()->showMessage("Не удалось загрузить заметки", 3000);
+        return;
     }
+    notesPanelEdit_->setPlainText(QString::fromStdString(*notes));
+    notesPanelEdit_->setEnabled(true);
+    saveNotesButton_->setEnabled(true);
+}
+bool MainWindow::loadNotes(const Game& game, std::string& notes) {
+    notes.clear();
+    if (!game.has_notes) return true;
+    if (const std::string* cached = cachedNotes(game.id)) {
+        notes = *cached;
+        return true;
+    }
+    bool ok = false;
+    notes = dbManager_.getGameNotes(game.id, currentUser_.id, &ok);
+    if (ok) cacheNotes(game.id, notes);
+    return ok;
+}
+const std::string* MainWindow::cachedNotes(int gameId) {
+    // Незаписанные заметки из очереди новее любого кэша
+    if (const std::string* pending = dbManager_.pendingGameNotes(gameId)) {
+        return pending;
+    }
+    auto cached = notesCacheIndex_.find(gameId);
+    if (cached == notesCacheIndex_.end()) return nullptr;
+    notesCache_.splice(notesCache_.begin(), notesCache_, cached->second);
+    return &cached->second->second;
+}
+void MainWindow::cacheNotes(int gameId, std::string notes) {
+    auto cached = notesCacheIndex_.find(gameId);
+    if (cached != notesCacheIndex_.end()) {
+        cached->second->second = std::move(notes);
+        notesCache_.splice(notesCache_.begin(), notesCache_, cached->second);
+        return;
+    }
+    notesCache_.emplace_front(gameId, std::move(notes));
+    notesCacheIndex_[gameId] = notesCache_.begin();
+    if (notesCache_.size() > NOTES_CACHE_SIZE) {
+        notesCacheIndex_.erase(notesCache_.back().first);
+        notesCache_.pop_back();
+    }
+}
+void MainWindow::clearNotesCache() {
+    notesCache_.clear();
+    notesCacheIndex_.clear();
+    notesWaitingGameId_ = -1;
 }
 void MainWindow::onSaveNotes() {
     if (currentNotesGameId_ <= 0) {
@@ -746,24 +1066,80 @@ void MainWindow::onSaveNotes() {
         return;
     }
     QString notes = notesPanelEdit_->toPlainText();
-    if (dbManager_.updateGameNotes(currentNotesGameId_, currentUser_.id, notes.toStdString())) {
-        int row = gamesTable_->currentRow();
-        if (row >= 0) {
-            QTableWidgetItem* idItem = gamesTable_->item(row, 0);
-            if (idItem) {
-                idItem->setData(Qt::UserRole + 1, notes);
-            }
+    // Запись в базу отложена: кэш и строка таблицы обновляются сразу
+    dbManager_.queueGameNotes(currentNotesGameId_, currentUser_.id, notes.toStdString());
+    cacheNotes(currentNotesGameId_, notes.toStdString());
+    int row = gamesModel_->rowOfGame(currentNotesGameId_);
+    if (row >= 0) {
+        Game game = gamesModel_->gameAt(row);
+        game.has_notes = !notes.isEmpty();
+        game.notes_preview = notes.left(NOTES_PREVIEW_LENGTH).toStdString();
+        gamesModel_->upsertGame(game);
+    }
+    onPendingWriteQueued();
+    statusBar()->showMessage("Заметки сохранены", 3000);
+}
+void MainWindow::toggleGameFlag(const QModelIndex& index) {
+    int row = gamesProxy_->mapToSource(index).row();
+    if (row < 0) return;
+    Game game = gamesModel_->gameAt(row);
+    DatabaseManager::GameFlag flag = DatabaseManager::GameFlag::Completed;
+    bool* value = &game.completed;
+    if (index.column() == GameTableModel::ColFavorite) {
+        flag = DatabaseManager::GameFlag::Favorite;
+        value = &game.is_favorite;
+    } else if (index.column() == GameTableModel::ColInstalled) {
+        flag = DatabaseManager::GameFlag::Installed;
+        value = &game.is_installed;
+    }
+    *value = !*value;
+    dbManager_.queueGameFlag(game.id, currentUser_.id, flag, *value);
+    gamesModel_->upsertGame(game);
+    flagWritesPending_ = true;
+    onPendingWriteQueued();
+}
+void MainWindow::onPendingWriteQueued() {
+    // Таймер не перезапускается: частые изменения не откладывают запись бесконечно
+    if (!writeBehindTimer_->isActive()) {
+        writeBehindTimer_->start();
+    }
+    updatePendingWritesIndicator();
+}
+bool MainWindow::flushPendingWrites() {
+    writeBehindTimer_->stop();
+    bool ok = dbManager_.flushPendingWrites();
+    if (!ok) {
+        statusBar()->showMessage(QString("Изменения не записаны: %1")
+            .arg(QString::fromStdString(dbManager_.getLastError())), 5000);
+        writeBehindTimer_->start();
+    } else if (flagWritesPending_) {
+        flagWritesPending_ = false;
+        // Флаги меняют статистику, фасеты и, при фильтре, состав таблицы
+        scheduleRefresh(RefreshStats | RefreshFacets | (filterActive_ ? RefreshTable | RefreshCount : 0u));
+    }
+    updatePendingWritesIndicator();
+    return ok;
+}
+void MainWindow::updatePendingWritesIndicator() {
+    size_t pending = dbManager_.pendingWriteCount();
+    pendingWritesLabel_->setVisible(pending > 0);
+    pendingWritesLabel_->setText(QString("● не записано: %1").arg(pending));
+}
+void MainWindow::closeEvent(QCloseEvent* event) {
+    if (!flushPendingWrites()) {
+        QMessageBox::StandardButton reply = QMessageBox::question(this, "Выход",
+            QString("Не удалось записать изменения (%1). Выйти без сохранения?")
+                .arg(QString::fromStdString(dbManager_.getLastError())),
+            QMessageBox::Yes | QMessageBox::No);
+        if (reply != QMessageBox::Yes) {
+            event->ignore();
+            return;
         }
-        statusBar()->showMessage("Заметки сохранены", 3000);
-    } else {
-        QMessageBox::critical(this, "Ошибка", 
-            QString("Не удалось сохранить заметки:
-%1")
-                .arg(QString::fromStdString(dbManager_.getLastError())));
     }
+    event->accept();
 }
 void MainWindow::updateButtonStates() {
-    bool hasSelection = gamesTable_->currentRow() >= 0 && 
+    bool hasSelection = currentGameRow() >= 0 && 
                         gamesTable_->selectionModel()->hasSelection();
     editButton_->setEnabled(hasSelection);
     deleteButton_->setEnabled(hasSelection);
@@ -785,7 +1161,9 @@ void MainWindow::showLoginPage() {
     deleteAction_->setEnabled(false);
     exportAction_->setEnabled(false);
     exportFilteredAction_->setEnabled(false);
+    exportDeltaAction_->setEnabled(false);
     importAction_->setEnabled(false);
+    importChainAction_->setEnabled(false);
     viewExportedAction_->setEnabled(false);
     adminMenu_->menuAction()->setVisible(false);
     passwordEdit_->clear();
@@ -801,17 +1179,16 @@ void MainWindow::showMainPage() {
     addAction_->setEnabled(true);
     exportAction_->setEnabled(true);
     exportFilteredAction_->setEnabled(true);
+    exportDeltaAction_->setEnabled(true);
     importAction_->setEnabled(true);
+    importChainAction_->setEnabled(true);
     viewExportedAction_->setEnabled(true);
     adminMenu_->menuAction()->setVisible(currentUser_.is_admin);
     QString userType = currentUser_.is_admin ? "👑 Администратор" : "👤 Пользователь";
     userInfoLabel_->setText(QString("%1: %2").arg(userType, QString::fromStdString(currentUser_.username)));
     lastClickedRow_ = -1;
     resetTableColumnWidths();
-    updateTagsCombo();
-    updateGamesTable();
-    updateStatusBar();
-    updateStats();
+    scheduleRefresh(RefreshAll);
 }
 void MainWindow::onLogin() {
     QString username = usernameEdit_->text().trimmed();
@@ -877,13 +1254,21 @@ void MainWindow::onRegister() {
     }
 }
 void MainWindow::onLogout() {
+    flushPendingWrites();
+    ++filterGeneration_;
+    ++facetGeneration_;
+    lastFacets_.reset();
+    filterDebounce_->stop();
     currentUser_ = User();
     filterActive_ = false;
     currentFilter_.reset();
     lastClickedRow_ = -1;
+    pendingRefresh_ = 0;
+    gamesModel_->clear();
     notesPanel_->setVisible(false);
     notesButton_->setChecked(false);
     currentNotesGameId_ = -1;
+    clearNotesCache();
     showLoginPage();
     statusBar()->showMessage("Вы вышли из системы");
 }
@@ -892,10 +1277,20 @@ void MainWindow::onAddGame() {
     if (dialog.exec() == QDialog::Accepted) {
         Game game = dialog.getGame();
         game.user_id = currentUser_.id;
-        if (dbManager_.addGame(game)) {
-            updateTagsCombo();
-            updateGamesTable();
-            updateStats();
+        Game saved;
+        uint64_t commitsBefore = dbManager_.commitCount();
+        if (dbManager_.addGame(game, &saved)) {
+            noteEditCommits(commitsBefore);
+            unsigned refresh = RefreshCount | RefreshStats | RefreshFacets;
+            if (!saved.tags.empty()) {
+                refresh |= RefreshTags;
+            }
+            if (filterActive_) {
+                refresh |= RefreshTable;
+            } else {
+                selectGameRow(gamesModel_->upsertGame(saved));
+            }
+            scheduleRefresh(refresh);
             statusBar()->showMessage("Игра добавлена");
         } else {
             QMessageBox::critical(this, "Ошибка", 
@@ -905,15 +1300,17 @@ void MainWindow::onAddGame() {
     }
 }
 void MainWindow::onEditGame() {
-    int currentRow = gamesTable_->currentRow();
+    int currentRow = currentGameRow();
     if (currentRow < 0 || !gamesTable_->selectionModel()->hasSelection()) {
         QMessageBox::warning(this, "Внимание", "Выберите игру для редактирования!");
         return;
     }
-    int gameId = gamesTable_->item(currentRow, 0)->text().toInt();
-    Game game = dbManager_.getGameById(gameId, currentUser_.id);
-    if (game.id == 0) {
-        QMessageBox::warning(this, "Ошибка", "Игра не найдена!");
+    Game game = gamesModel_->gameAt(currentRow);
+    // Диалог сохраняет заметки целиком, поэтому без полного текста редактировать нельзя
+    if (!loadNotes(game, game.notes)) {
+        QMessageBox::critical(this, "Ошибка", 
+            QString("Не удалось загрузить заметки: %1")
+                .arg(QString::fromStdString(dbManager_.getLastError())));
         return;
     }
     GameEditDialog dialog(this, &game);
@@ -921,10 +1318,21 @@ void MainWindow::onEditGame() {
         Game updatedGame = dialog.getGame();
         updatedGame.id = game.id;
         updatedGame.user_id = currentUser_.id;
-        if (dbManager_.updateGame(updatedGame)) {
-            updateTagsCombo();
-            updateGamesTable();
-            updateStats();
+        Game saved;
+        uint64_t commitsBefore = dbManager_.commitCount();
+        if (dbManager_.updateGame(updatedGame, &saved)) {
+            noteEditCommits(commitsBefore);
+            cacheNotes(saved.id, updatedGame.notes);
+            unsigned refresh = RefreshStats | RefreshFacets;
+            if (saved.tags != game.tags) {
+                refresh |= RefreshTags;
+            }
+            if (filterActive_) {
+                refresh |= RefreshTable | RefreshCount;
+            } else {
+                selectGameRow(gamesModel_->upsertGame(saved));
+            }
+            scheduleRefresh(refresh);
             statusBar()->showMessage("Игра обновлена");
         } else {
             QMessageBox::critical(this, "Ошибка", 
@@ -934,22 +1342,31 @@ void MainWindow::onEditGame() {
     }
 }
 void MainWindow::onDeleteGame() {
-    int currentRow = gamesTable_->currentRow();
+    std::vector<int> selectedIds = selectedGameIds();
+    if (selectedIds.size() > 1) {
+        deleteSelectedGames(selectedIds);
+        return;
+    }
+    int currentRow = currentGameRow();
     if (currentRow < 0 || !gamesTable_->selectionModel()->hasSelection()) {
         QMessageBox::warning(this, "Внимание", "Выберите игру для удаления!");
         return;
     }
-    QString gameName = gamesTable_->item(currentRow, 1)->text();
-    int gameId = gamesTable_->item(currentRow, 0)->text().toInt();
+    const Game game = gamesModel_->gameAt(currentRow);
+    QString gameName = QString::fromStdString(game.name);
+    int gameId = game.id;
     QMessageBox::StandardButton reply = QMessageBox::question(this, "Подтверждение",
         QString("Вы уверены, что хотите удалить игру \"%1\"?").arg(gameName),
         QMessageBox::Yes | QMessageBox::No);
     if (reply == QMessageBox::Yes) {
+        uint64_t commitsBefore = dbManager_.commitCount();
         if (dbManager_.deleteGame(gameId, currentUser_.id)) {
+            noteEditCommits(commitsBefore);
             lastClickedRow_ = -1;
-            updateTagsCombo();
-            updateGamesTable();
-            updateStats();
+            gamesModel_->removeGame(gameId);
+            gamesTable_->clearSelection();
+            updateButtonStates();
+            scheduleRefresh(RefreshCount | RefreshStats | RefreshFacets);
             statusBar()->showMessage(QString("Игра \"%1\" удалена").arg(gameName));
         } else {
             QMessageBox::critical(this, "Ошибка", 
@@ -960,66 +1377,240 @@ void MainWindow::onDeleteGame() {
 }
 void MainWindow::onRefreshGames() {
     resetTableColumnWidths();
-    updateTagsCombo();
-    updateGamesTable();
-    updateStats();
+    flushPendingWrites();
+    scheduleRefresh(RefreshAll);
     statusBar()->showMessage("Данные обновлены, настройки отображения сброшены");
 }
-void MainWindow::onApplyFilter() {
-    currentFilter_.reset();
+GameFilter MainWindow::readFilterPanel() const {
+    GameFilter filter;
     if (filterCompletedCheck_->isChecked()) {
-        currentFilter_.filter_completed = true;
-        currentFilter_.completed_value = filterCompletedCombo_->currentData().toBool();
+        filter.filter_completed = true;
+        filter.completed_value = filterCompletedCombo_->currentData().toBool();
     }
     if (filterGenreCheck_->isChecked() && filterGenreCombo_->currentData().toInt() > 0) {
-        currentFilter_.filter_genre = true;
-        currentFilter_.genre_id = filterGenreCombo_->currentData().toInt();
+        filter.filter_genre = true;
+        filter.genre_id = filterGenreCombo_->currentData().toInt();
     }
     if (filterDiskMinCheck_->isChecked()) {
-        currentFilter_.filter_disk_space_min = true;
-        currentFilter_.disk_space_min = filterDiskMinSpin_->value();
+        filter.filter_disk_space_min = true;
+        filter.disk_space_min = filterDiskMinSpin_->value();
     }
     if (filterDiskMaxCheck_->isChecked()) {
-        currentFilter_.filter_disk_space_max = true;
-        currentFilter_.disk_space_max = filterDiskMaxSpin_->value();
+        filter.filter_disk_space_max = true;
+        filter.disk_space_max = filterDiskMaxSpin_->value();
     }
     if (filterRamMinCheck_->isChecked()) {
-        currentFilter_.filter_ram_min = true;
-        currentFilter_.ram_min = filterRamMinSpin_->value();
+        filter.filter_ram_min = true;
+        filter.ram_min = filterRamMinSpin_->value();
     }
     if (filterRamMaxCheck_->isChecked()) {
-        currentFilter_.filter_ram_max = true;
-        currentFilter_.ram_max = filterRamMaxSpin_->value();
+        filter.filter_ram_max = true;
+        filter.ram_max = filterRamMaxSpin_->value();
     }
     if (filterVramMinCheck_->isChecked()) {
-        currentFilter_.filter_vram_min = true;
-        currentFilter_.vram_min = filterVramMinSpin_->value();
+        filter.filter_vram_min = true;
+        filter.vram_min = filterVramMinSpin_->value();
     }
     if (filterVramMaxCheck_->isChecked()) {
-        currentFilter_.filter_vram_max = true;
-        currentFilter_.vram_max = filterVramMaxSpin_->value();
+        filter.filter_vram_max = true;
+        filter.vram_max = filterVramMaxSpin_->value();
     }
     if (filterTagCheck_->isChecked() && filterTagCombo_->currentData().toInt() > 0) {
-        currentFilter_.filter_tag = true;
-        currentFilter_.tag_id = filterTagCombo_->currentData().toInt();
+        filter.filter_tag = true;
+        filter.tag_id = filterTagCombo_->currentData().toInt();
     }
     if (filterFavoriteCheck_->isChecked()) {
-        currentFilter_.filter_favorite = true;
-        currentFilter_.favorite_value = filterFavoriteCombo_->currentData().toBool();
+        filter.filter_favorite = true;
+        filter.favorite_value = filterFavoriteCombo_->currentData().toBool();
     }
     if (filterInstalledCheck_->isChecked()) {
-        currentFilter_.filter_installed = true;
-        currentFilter_.installed_value = filterInstalledCombo_->currentData().toBool();
+        filter.filter_installed = true;
+        filter.installed_value = filterInstalledCombo_->currentData().toBool();
     }
     if (filterRatingCheck_->isChecked()) {
-        currentFilter_.filter_has_rating = true;
-        currentFilter_.has_rating_value = filterRatingCombo_->currentData().toInt() == 1;
+        filter.filter_has_rating = true;
+        filter.has_rating_value = filterRatingCombo_->currentData().toInt() == 1;
     }
-    filterActive_ = true;
-    lastClickedRow_ = -1;
-    updateGamesTable();
+    QString name = filterNameEdit_->text().trimmed();
+    if (!name.isEmpty()) {
+        filter.filter_name = true;
+        filter.name_query = name.toStdString();
+    }
+    return filter;
+}
+void MainWindow::onApplyFilter() {
+    filterLatency_.restart();
+    startFilterQuery();
     statusBar()->showMessage("Фильтр применен");
 }
+void MainWindow::onFilterChanged() {
+    if (currentUser_.id == 0) return;
+    filterLatency_.restart();
+    filterDebounce_->start();
+}
+void MainWindow::startFilterQuery() {
+    filterDebounce_->stop();
+    if (currentUser_.id == 0) return;
+    flushPendingWrites();
+    GameFilter filter = readFilterPanel();
+    bool active = filter.isActive();
+    int generation = ++filterGeneration_;
+    if (!filterDb_.isConnected()) {
+        currentFilter_ = filter;
+        filterActive_ = active;
+        lastClickedRow_ = -1;
+        scheduleRefresh(RefreshTable | RefreshCount | RefreshFacets);
+        runScheduledRefresh();
+        lastFilterLatencyMs_ = filterLatency_.isValid() ? filterLatency_.elapsed() : -1;
+        updateDebugOverlay();
+        return;
+    }
+    if (filterQueriesInFlight_ > 0) {
+        filterDb_.cancelQuery();
+        ++filterQueriesCancelled_;
+    }
+    ++filterQueriesInFlight_;
+    int userId = currentUser_.id;
+    GameSort sort = gamesModel_->sort();
+    DatabaseManager* db = &filterDb_;
+    // Текст ошибки снимается в рабочем потоке: к приходу результата соединение
+    // может уже выполнять запрос фасет и перезаписать getLastError()
+    auto error = std::make_shared<std::string>();
+    auto* watcher = new QFutureWatcher<std::optional<GameResultView>>(this);
+    connect(watcher, &QFutureWatcher<std::optional<GameResultView>>::finished, this,
+            [this, watcher, generation, filter, active, error]() {
+        watcher->deleteLater();
+        --filterQueriesInFlight_;
+        if (generation != filterGeneration_.load()) {
+            ++filterResultsDiscarded_;
+            updateDebugOverlay();
+            return;
+        }
+        std::optional<GameResultView> page = watcher->result();
+        if (!page) {
+            // Ошибка — не пустой результат: таблица остаётся с прежними строками и фильтром
+            statusBar()->showMessage(QString("Не удалось применить фильтр: %1")
+                .arg(QString::fromStdString(*error)), 5000);
+            lastFilterLatencyMs_ = -1;
+            updateDebugOverlay();
+            return;
+        }
+        currentFilter_ = filter;
+        filterActive_ = active;
+        lastClickedRow_ = -1;
+        gamesTable_->clearSelection();
+        gamesModel_->setSource(&dbManager_, currentUser_.id, filterActive_ ? &currentFilter_ : nullptr, *page);
+        updateButtonStates();
+        scheduleRefresh(RefreshCount);
+        lastFilterLatencyMs_ = filterLatency_.isValid() ? filterLatency_.elapsed() : -1;
+        updateDebugOverlay();
+    });
+    watcher->setFuture(QtConcurrent::run(&filterPool_, [this, db, userId, filter, sort, active, generation, error]() {
+        // Результат запроса переходит в поток GUI целиком и разбирается уже там, при переносе в модель
+        std::optional<GameResultView> result;
+        // Пока запрос ждал в очереди, панель могла измениться ещё раз
+        if (generation != filterGeneration_.load()) return result;
+        bool ok = false;
+        GameResultView page = db->getGamesPage(userId, active ? &filter : nullptr, sort, GamePageKey(),
+                                               GameTableModel::PAGE_SIZE, &ok);
+        if (!ok && generation == filterGeneration_.load()) {
+            // Отмена, отправленная предыдущему запросу, могла прийти уже к этому — повторяем
+            page = db->getGamesPage(userId, active ? &filter : nullptr, sort, GamePageKey(),
+                                    GameTableModel::PAGE_SIZE, &ok);
+        }
+        if (ok) {
+            result = std::move(page);
+        } else {
+            *error = db->getLastError();
+        }
+        return result;
+    }));
+    // Фасеты встают в очередь после первой страницы: таблица обновится раньше счётчиков
+    requestFacets(filter);
+}
+void MainWindow::requestFacets(const GameFilter& filter) {
+    if (currentUser_.id == 0) return;
+    int generation = ++facetGeneration_;
+    int userId = currentUser_.id;
+    if (!filterDb_.isConnected()) {
+        bool ok = false;
+        FacetCounts counts = dbManager_.getFacetCounts(userId, filter, &ok);
+        if (ok) applyFacetCounts(counts);
+        return;
+    }
+    ++filterQueriesInFlight_;
+    DatabaseManager* db = &filterDb_;
+    auto* watcher = new QFutureWatcher<std::optional<FacetCounts>>(this);
+    connect(watcher, &QFutureWatcher<std::optional<FacetCounts>>::finished, this, [this, watcher, generation]() {
+        watcher->deleteLater();
+        --filterQueriesInFlight_;
+        std::optional<FacetCounts> counts = watcher->result();
+        if (generation == facetGeneration_.load() && counts) {
+            applyFacetCounts(*counts);
+        }
+    });
+    watcher->setFuture(QtConcurrent::run(&filterPool_, [this, db, userId, filter, generation]() {
+        std::optional<FacetCounts> result;
+        if (generation != facetGeneration_.load()) return result;
+        bool ok = false;
+        FacetCounts counts = db->getFacetCounts(userId, filter, &ok);
+        if (!ok && generation == facetGeneration_.load()) {
+            counts = db->getFacetCounts(userId, filter, &ok);
+        }
+        if (ok) result = counts;
+        return result;
+    }));
+}
+void MainWindow::applyFacetCounts(const FacetCounts& counts) {
+    lastFacets_ = counts;
+    auto countOf = [](const std::map<int, int>& facet, int id) {
+        auto it = facet.find(id);
+        return it == facet.end() ? 0 : it->second;
+    };
+    for (int i = 0; i < filterGenreCombo_->count(); ++i) {
+        int genreId = filterGenreCombo_->itemData(i).toInt();
+        setComboFacetCount(filterGenreCombo_, i, genreId > 0 ? countOf(counts.genres, genreId) : counts.all_genres);
+    }
+    for (int i = 0; i < filterTagCombo_->count(); ++i) {
+        int tagId = filterTagCombo_->itemData(i).toInt();
+        setComboFacetCount(filterTagCombo_, i, tagId > 0 ? countOf(counts.tags, tagId) : counts.all_tags);
+    }
+    auto setFlagCounts = [](QComboBox* combo, const std::array<int, 2>& flag) {
+        for (int i = 0; i < combo->count(); ++i) {
+            setComboFacetCount(combo, i, flag[combo->itemData(i).toInt() != 0 ? 1 : 0]);
+        }
+    };
+    setFlagCounts(filterCompletedCombo_, counts.completed);
+    setFlagCounts(filterFavoriteCombo_, counts.favorite);
+    setFlagCounts(filterInstalledCombo_, counts.installed);
+    setFlagCounts(filterRatingCombo_, counts.rated);
+    diskFacetLabel_->setText(facetHistogramText(DISK_FACET_EDGES, counts.disk));
+    ramFacetLabel_->setText(facetHistogramText(RAM_FACET_EDGES, counts.ram));
+    vramFacetLabel_->setText(facetHistogramText(VRAM_FACET_EDGES, counts.vram));
+    filterGroupBox_->setTitle(QString("Фильтры (найдено: %1)").arg(counts.total));
+}
+void MainWindow::updateDebugOverlay() {
+    if (debugOverlayLabel_->isHidden()) return;
+    const GameStore& store = gamesModel_->store();
+    debugOverlayLabel_->setText(
+        QString("фильтр: %1 мс | отменено: %2 | отброшено: %3 | обновления: %4 из %5 | таблица: %6 кадр/с, %7 | "
+                "страница: %8 мкс | обновление: %9 мс | коммитов на правку: %10")
+        .arg(lastFilterLatencyMs_ < 0 ? QString("—") : QString::number(lastFilterLatencyMs_))
+        .arg(filterQueriesCancelled_)
+        .arg(filterResultsDiscarded_)
+        .arg(refreshPartsRun_)
+        .arg(refreshPartsRequested_)
+        .arg(tableFps_ < 0 ? QString("—") : QString::number(tableFps_, 'f', 0))
+        .arg(store.empty() ? QString("—")
+                           : QString("%1 Б/игру").arg(store.memoryUsage() / store.size()))
+        .arg(gamesModel_->lastPageMicros() < 0 ? QString("—") : QString::number(gamesModel_->lastPageMicros()))
+        .arg(lastRefreshLatencyMs_ < 0 ? QString("—") : QString::number(lastRefreshLatencyMs_))
+        .arg(lastEditCommits_ < 0 ? QString("—") : QString::number(lastEditCommits_)));
+}
+void MainWindow::noteEditCommits(uint64_t commitsBefore) {
+    lastEditCommits_ = static_cast<qint64>(dbManager_.commitCount() - commitsBefore);
+    updateDebugOverlay();
+}
 void MainWindow::onResetFilter() {
     filterCompletedCheck_->setChecked(false);
     filterGenreCheck_->setChecked(false);
@@ -1034,16 +1625,16 @@ void MainWindow::onResetFilter() {
     filterInstalledCheck_->setChecked(false);
     filterRatingCheck_->setChecked(false);
     filterTagCombo_->setCurrentIndex(0);
-    currentFilter_.reset();
-    filterActive_ = false;
-    lastClickedRow_ = -1;
-    updateGamesTable();
+    filterNameEdit_->clear();
+    filterLatency_.restart();
+    startFilterQuery();
     statusBar()->showMessage("Фильтр сброшен");
 }
 void MainWindow::onExportToFile() {
     QString filename = QFileDialog::getSaveFileName(this, "Экспорт в файл",
         QDir::homePath() + "/games_export.bin", "Бинарные файлы (*.bin)");
     if (filename.isEmpty()) return;
+    flushPendingWrites();
     if (dbManager_.exportToBinaryFile(filename.toStdString(), currentUser_.id)) {
         lastExportedFile_ = filename;
         QMessageBox::information(this, "Успех", 
@@ -1063,6 +1654,7 @@ void MainWindow::onExportFilteredToFile() {
     QString filename = QFileDialog::getSaveFileName(this, "Экспорт отфильтрованных данных",
         QDir::homePath() + "/games_filtered_export.bin", "Бинарные файлы (*.bin)");
     if (filename.isEmpty()) return;
+    flushPendingWrites();
     if (dbManager_.exportFilteredToBinaryFile(filename.toStdString(), currentUser_.id, currentFilter_)) {
         lastExportedFile_ = filename;
         QMessageBox::information(this, "Успех", 
@@ -1073,26 +1665,97 @@ void MainWindow::onExportFilteredToFile() {
             QString("Ошибка экспорта: %1").arg(QString::fromStdString(dbManager_.getLastError())));
     }
 }
+void MainWindow::onExportDeltaToFile() {
+    QString baseFile = QFileDialog::getOpenFileName(this, "Базовый экспорт (полный или предыдущая дельта)",
+        lastExportedFile_.isEmpty() ? QDir::homePath() : lastExportedFile_, "Бинарные файлы (*.bin)");
+    if (baseFile.isEmpty()) return;
+    QString filename = QFileDialog::getSaveFileName(this, "Экспорт изменений",
+        QDir::homePath() + "/games_delta.bin", "Бинарные файлы (*.bin)");
+    if (filename.isEmpty()) return;
+    flushPendingWrites();
+    if (dbManager_.exportDeltaToBinaryFile(filename.toStdString(), currentUser_.id, baseFile.toStdString())) {
+        lastExportedFile_ = filename;
+        QMessageBox::information(this, "Успех",
+            QString("Изменения с момента экспорта \"%1\" сохранены.")
+                .arg(QFileInfo(baseFile).fileName()));
+    } else {
+        QMessageBox::critical(this, "Ошибка",
+            QString("Ошибка экспорта: %1").arg(QString::fromStdString(dbManager_.getLastError())));
+    }
+}
+void MainWindow::onImportDeltaChain() {
+    QStringList files = QFileDialog::getOpenFileNames(this, "Полный экспорт и дельты",
+        QDir::homePath(), "Бинарные файлы (*.bin)");
+    if (files.isEmpty()) return;
+    flushPendingWrites();
+    std::vector<std::string> filenames;
+    for (const QString& file : files) {
+        filenames.push_back(file.toStdString());
+    }
+    if (dbManager_.importDeltaChain(filenames, currentUser_.id)) {
+        scheduleRefresh(RefreshAll);
+        QMessageBox::information(this, "Успех",
+            QString("Восстановлено из %1 файл(ов).").arg(files.size()));
+    } else {
+        scheduleRefresh(RefreshTable | RefreshCount | RefreshStats | RefreshFacets);
+        QMessageBox::critical(this, "Ошибка",
+            QString("Ошибка восстановления: %1").arg(QString::fromStdString(dbManager_.getLastError())));
+    }
+}
 void MainWindow::onImportFromFile() {
     QString filename = QFileDialog::getOpenFileName(this, "Импорт из файла",
         QDir::homePath(), "Бинарные файлы (*.bin)");
     if (filename.isEmpty()) return;
-    FileVerificationResult verification = dbManager_.verifyBinaryFile(filename.toStdString());
-    if (verification != FileVerificationResult::OK) {
+    flushPendingWrites();
+    FileVerificationResult verification = FileVerificationResult::OK;
+    if (dbManager_.importFromBinaryFile(filename.toStdString(), currentUser_.id, verification)) {
+        scheduleRefresh(RefreshAll);
+        QMessageBox::information(this, "Успех", 
+            "Данные успешно импортированы!
+Контрольная сумма файла подтверждена.");
+    } else if (verification == FileVerificationResult::HASH_MISMATCH) {
+        offerSalvageImport(filename);
+    } else if (verification != FileVerificationResult::OK) {
         QMessageBox::critical(this, "Ошибка верификации",
             QString("Файл не прошел проверку:
 %1
 Импорт отменён.")
                 .arg(QString::fromStdString(DatabaseManager::getVerificationErrorText(verification))));
+    } else {
+        QMessageBox::critical(this, "Ошибка", 
+            QString("Ошибка импорта: %1").arg(QString::fromStdString(dbManager_.getLastError())));
+    }
+}
+void MainWindow::offerSalvageImport(const QString& filename) {
+    std::vector<uint32_t> damaged;
+    FileVerificationResult check = dbManager_.quickCheckBinaryFile(filename.toStdString(), &damaged);
+    if (check != FileVerificationResult::OK && check != FileVerificationResult::HASH_MISMATCH) {
+        QMessageBox::critical(this, "Ошибка верификации",
+            QString("Файл не прошел проверку:\n%1\nИмпорт отменён.")
+                .arg(QString::fromStdString(DatabaseManager::getVerificationErrorText(
+                    FileVerificationResult::HASH_MISMATCH))));
         return;
     }
-    if (dbManager_.importFromBinaryFile(filename.toStdString(), currentUser_.id)) {
-        updateGamesTable();
-        QMessageBox::information(this, "Успех", 
-            "Данные успешно импортированы!
-Контрольная сумма файла подтверждена.");
+    QStringList numbers;
+    for (size_t i = 0; i < damaged.size() && i < 20; ++i) {
+        numbers << QString::number(damaged[i] + 1);
+    }
+    if (damaged.size() > 20) {
+        numbers << "...";
+    }
+    QString details = damaged.empty()
+        ? QString("Все записи целы, повреждены служебные данные файла.")
+        : QString("Повреждено записей: %1 (№ %2).").arg(damaged.size()).arg(numbers.join(", "));
+    QMessageBox::StandardButton reply = QMessageBox::question(this, "Повреждённый файл",
+        QString("Контрольная сумма файла не совпадает.\n%1\n\nИмпортировать уцелевшие записи?").arg(details),
+        QMessageBox::Yes | QMessageBox::No);
+    if (reply != QMessageBox::Yes) return;
+    if (dbManager_.salvageImportFromBinaryFile(filename.toStdString(), currentUser_.id, damaged)) {
+        scheduleRefresh(RefreshAll);
+        QMessageBox::information(this, "Импорт завершён",
+            QString("Уцелевшие записи импортированы.\nПропущено повреждённых записей: %1").arg(damaged.size()));
     } else {
-        QMessageBox::critical(this, "Ошибка", 
+        QMessageBox::critical(this, "Ошибка",
             QString("Ошибка импорта: %1").arg(QString::fromStdString(dbManager_.getLastError())));
     }
 }
@@ -1101,39 +1764,30 @@ void MainWindow::onViewExportedFile() {
         lastExportedFile_.isEmpty() ? QDir::homePath() : lastExportedFile_, 
         "Бинарные файлы (*.bin)");
     if (filename.isEmpty()) return;
-    FileVerificationResult verification = dbManager_.verifyBinaryFile(filename.toStdString());
-    if (verification != FileVerificationResult::OK) {
-        QMessageBox::warning(this, "Предупреждение",
-            QString("Файл не прошел проверку:
-%1
-Просмотр может быть некорректным.")
-                .arg(QString::fromStdString(DatabaseManager::getVerificationErrorText(verification))));
+    BinaryFileViewDialog dialog(&dbManager_, filename, this);
+    if (!dialog.isFileOpen()) {
+        QMessageBox::critical(this, "Ошибка",
+            QString("Не удалось открыть файл: %1").arg(dialog.errorString()));
+        return;
     }
-    std::vector<Game> games = dbManager_.readBinaryFile(filename.toStdString());
-    if (games.empty() && verification == FileVerificationResult::OK) {
+    if (dialog.recordCount() == 0) {
         QMessageBox::information(this, "Информация", "Файл пуст.");
         return;
     }
-    BinaryFileViewDialog dialog(games, filename, this);
     dialog.exec();
 }
 void MainWindow::onTableSelectionChanged() {
     updateButtonStates();
+    int row = currentGameRow();
+    if (row < 0) return;
+    const Game game = gamesModel_->gameAt(row);
     if (notesPanel_->isVisible()) {
-        int row = gamesTable_->currentRow();
-        if (row >= 0) {
-            QTableWidgetItem* idItem = gamesTable_->item(row, 0);
-            if (idItem) {
-                int gameId = idItem->text().toInt();
-                if (gameId != currentNotesGameId_) {
-                    QString gameName = gamesTable_->item(row, 1)->text();
-                    QString notes = idItem->data(Qt::UserRole + 1).toString();
-                    currentNotesGameId_ = gameId;
-                    notesPanelTitle_->setText(QString("📝 Заметки: %1").arg(gameName));
-                    notesPanelEdit_->setPlainText(notes);
-                }
-            }
+        if (game.id != currentNotesGameId_) {
+            showNotesInPanel(game);
         }
+    } else {
+        // Панель закрыта: заметки подгружаются заранее, чтобы открыть её без ожидания
+        prefetchNotes(game);
     }
 }
 void MainWindow::onAdminPanel() {
@@ -1190,112 +1844,165 @@ void MainWindow::resetTableColumnWidths() {
     gamesTable_->setColumnWidth(10, 100);
 }
 void MainWindow::updateGamesTable() {
-    std::vector<Game> games;
+    gamesTable_->clearSelection();
+    gamesModel_->setSource(&dbManager_, currentUser_.id, filterActive_ ? &currentFilter_ : nullptr);
+    updateButtonStates();
+}
+// Число запрошенных частей обновления (для счётчиков оверлея)
+static int refreshPartCount(unsigned flags) {
+    return static_cast<int>(qPopulationCount(static_cast<quint32>(flags)));
+}
+void MainWindow::scheduleRefresh(unsigned flags) {
+    refreshPartsRequested_ += refreshPartCount(flags);
+    if (pendingRefresh_ == 0) {
+        QTimer::singleShot(0, this, &MainWindow::runScheduledRefresh);
+    }
+    pendingRefresh_ |= flags;
+    updateDebugOverlay();
+}
+void MainWindow::runScheduledRefresh() {
+    unsigned flags = pendingRefresh_;
+    pendingRefresh_ = 0;
+    if (flags == 0 || currentUser_.id == 0) return;
+    refreshPartsRun_ += refreshPartCount(flags);
+    unsigned parts = refreshReadParts(flags);
+    int userId = currentUser_.id;
+    std::optional<GameFilter> filter;
     if (filterActive_) {
-        games = dbManager_.getFilteredGames(currentUser_.id, currentFilter_);
+        filter = currentFilter_;
+    }
+    refreshLatency_.restart();
+    if (parts != 0 && filterDb_.isConnected()) {
+        DatabaseManager* db = &filterDb_;
+        auto* watcher = new QFutureWatcher<RefreshReads>(this);
+        connect(watcher, &QFutureWatcher<RefreshReads>::finished, this, [this, watcher, userId]() {
+            watcher->deleteLater();
+            if (userId == currentUser_.id) {
+                applyRefreshResults(watcher->result());
+                lastRefreshLatencyMs_ = refreshLatency_.elapsed();
+                updateDebugOverlay();
+            }
+        });
+        watcher->setFuture(QtConcurrent::run(&filterPool_, [this, db, parts, userId, filter]() {
+            // Независимые чтения уходят одним конвейером, каждый ответ показывается сразу;
+            // не полученные из конвейера части читаются по одной
+            unsigned received = db->readPipelined(parts, userId, filter ? &*filter : nullptr,
+                [this, userId](const RefreshReads& part) {
+                    QMetaObject::invokeMethod(this, [this, userId, part]() {
+                        if (userId == currentUser_.id) {
+                            applyRefreshResults(part);
+                        }
+                    }, Qt::QueuedConnection);
+                });
+            return loadRefreshResults(*db, parts & ~received, userId, filter ? &*filter : nullptr);
+        }));
+    } else if (parts != 0) {
+        applyRefreshResults(loadRefreshResults(dbManager_, parts, userId, filter ? &*filter : nullptr));
+        lastRefreshLatencyMs_ = refreshLatency_.elapsed();
+    }
+    if (flags & RefreshTable) {
+        updateGamesTable();
+    }
+    if (flags & RefreshFacets) {
+        requestFacets(currentFilter_);
+    }
+    updateDebugOverlay();
+}
+unsigned MainWindow::refreshReadParts(unsigned flags) {
+    unsigned parts = 0;
+    if (flags & RefreshCount) parts |= RefreshReads::Count;
+    if (flags & RefreshStats) parts |= RefreshReads::Stats;
+    if (flags & RefreshTags) parts |= RefreshReads::Tags;
+    if (flags & RefreshGenres) parts |= RefreshReads::Genres;
+    return parts;
+}
+RefreshReads MainWindow::loadRefreshResults(DatabaseManager& db, unsigned parts,
+                                            int userId, const GameFilter* filter) {
+    RefreshReads results;
+    auto load = [](auto query) -> std::optional<decltype(query(nullptr))> {
+        bool ok = false;
+        auto value = query(&ok);
+        if (!ok) {
+            value = query(&ok);
+        }
+        if (!ok) return std::nullopt;
+        return value;
+    };
+    if (parts & RefreshReads::Count) {
+        results.games_count = load([&](bool* ok) { return db.countGames(userId, filter, ok); });
+    }
+    if (parts & RefreshReads::Stats) {
+        results.stats = load([&](bool* ok) { return db.getGameStats(userId, ok); });
+    }
+    if (parts & RefreshReads::Tags) {
+        results.tags = load([&](bool* ok) { return db.getUserTags(userId, ok); });
+    }
+    if (parts & RefreshReads::Genres) {
+        results.genres = load([&](bool* ok) { return db.getAllGenres(ok); });
+    }
+    return results;
+}
+void MainWindow::applyRefreshResults(const RefreshReads& results) {
+    if (results.games_count) {
+        updateStatusBar(*results.games_count);
+    }
+    if (results.stats) {
+        updateStats(*results.stats);
+    }
+    if (results.tags) {
+        updateTagsCombo(*results.tags);
+    }
+    if (results.genres) {
+        updateGenresCombo(*results.genres);
+    }
+}
+void MainWindow::selectGameRow(int row) {
+    QModelIndex index = row < 0 ? QModelIndex() : gamesProxy_->mapFromSource(gamesModel_->index(row, 0));
+    if (!index.isValid()) {
+        gamesTable_->clearSelection();
     } else {
-        games = dbManager_.getAllGames(currentUser_.id);
+        gamesTable_->selectRow(index.row());
+        gamesTable_->scrollTo(index, QAbstractItemView::EnsureVisible);
     }
-    updateGamesTable(games);
+    updateButtonStates();
 }
-void MainWindow::updateGamesTable(const std::vector<Game>& games) {
-    gamesTable_->setRowCount(0);
-    gamesTable_->clearSelection();
-    for (const auto& game : games) {
-        int row = gamesTable_->rowCount();
-        gamesTable_->insertRow(row);
-        gamesTable_->setItem(row, 0, new QTableWidgetItem(QString::number(game.id)));
-        QString gameName = QString::fromStdString(game.name);
-        if (!game.notes.empty()) {
-            gameName += " 📝";
-        }
-        QTableWidgetItem* nameItem = new QTableWidgetItem(gameName);
-        if (!game.notes.empty()) {
-            nameItem->setToolTip("Есть заметки: " + QString::fromStdString(game.notes).left(100) + "...");
-        }
-        gamesTable_->setItem(row, 1, nameItem);
-        gamesTable_->setItem(row, 2, new QTableWidgetItem(QString::number(game.disk_space, 'f', 1)));
-        gamesTable_->setItem(row, 3, new QTableWidgetItem(QString::number(game.ram_usage, 'f', 1)));
-        gamesTable_->setItem(row, 4, new QTableWidgetItem(QString::number(game.vram_required, 'f', 1)));
-        gamesTable_->setItem(row, 5, new QTableWidgetItem(QString::fromStdString(game.genre)));
-        gamesTable_->setItem(row, 6, new QTableWidgetItem(game.completed ? "Да ✓" : "Нет"));
-        QString ratingStr = (game.rating < 0) ? "—" : QString::number(game.rating);
-        QTableWidgetItem* ratingItem = new QTableWidgetItem(ratingStr);
-        ratingItem->setTextAlignment(Qt::AlignCenter);
-        if (game.rating >= 8) {
-            ratingItem->setForeground(QColor("#4CAF50"));
-        } else if (game.rating >= 5 && game.rating < 8) {
-            ratingItem->setForeground(QColor("#FFC107"));
-        } else if (game.rating >= 0) {
-            ratingItem->setForeground(QColor("#F44336"));
-        }
-        gamesTable_->setItem(row, 7, ratingItem);
-        QTableWidgetItem* favItem = new QTableWidgetItem(game.is_favorite ? "★" : "");
-        favItem->setTextAlignment(Qt::AlignCenter);
-        if (game.is_favorite) {
-            favItem->setForeground(QColor("#FFD700"));
-            QFont favFont = favItem->font();
-            favFont.setPointSize(14);
-            favItem->setFont(favFont);
-        }
-        gamesTable_->setItem(row, 8, favItem);
-        QTableWidgetItem* installedItem = new QTableWidgetItem(game.is_installed ? "📥" : "");
-        installedItem->setTextAlignment(Qt::AlignCenter);
-        if (game.is_installed) {
-            installedItem->setForeground(QColor("#2196F3"));
-            QFont instFont = installedItem->font();
-            instFont.setPointSize(12);
-            installedItem->setFont(instFont);
-        }
-        gamesTable_->setItem(row, 9, installedItem);
-        QTableWidgetItem* tagsItem = new QTableWidgetItem(QString::fromStdString(game.tags));
-        tagsItem->setForeground(QColor(TEXT_SECONDARY));
-        gamesTable_->setItem(row, 10, tagsItem);
-        QTableWidgetItem* urlItem = new QTableWidgetItem();
-        if (!game.url.empty()) {
-            urlItem->setText("🔗 Открыть");
-            urlItem->setData(Qt::UserRole, QString::fromStdString(game.url));
-            urlItem->setForeground(QColor(ACCENT_COLOR));
-            urlItem->setToolTip(QString::fromStdString(game.url));
-            QFont linkFont = urlItem->font();
-            linkFont.setUnderline(true);
-            urlItem->setFont(linkFont);
-        }
-        gamesTable_->setItem(row, 11, urlItem);
-        gamesTable_->item(row, 0)->setData(Qt::UserRole + 1, QString::fromStdString(game.notes));
-        if (game.completed) {
-            QColor completedColor(30, 60, 30, 180);
-            for (int col = 0; col < gamesTable_->columnCount(); ++col) {
-                QTableWidgetItem* item = gamesTable_->item(row, col);
-                if (item) {
-                    item->setBackground(completedColor);
-                }
-            }
-        }
-        if (game.is_favorite && !game.completed) {
-            QColor favoriteColor(60, 50, 20, 150);
-            for (int col = 0; col < gamesTable_->columnCount(); ++col) {
-                QTableWidgetItem* item = gamesTable_->item(row, col);
-                if (item) {
-                    item->setBackground(favoriteColor);
-                }
-            }
-        }
+int MainWindow::currentGameRow() const {
+    QModelIndex index = gamesProxy_->mapToSource(gamesTable_->currentIndex());
+    return index.isValid() ? index.row() : -1;
+}
+void MainWindow::restoreTableSort() {
+    std::vector<GameSortProxyModel::SortKey> keys =
+        GameSortProxyModel::sortKeysFromString(settings_.value("gamesTable/sort").toString());
+    if (keys.empty()) {
+        keys.push_back({GameTableModel::ColName, Qt::AscendingOrder});
+    }
+    gamesProxy_->setSortKeys(keys);
+    gamesTable_->horizontalHeader()->setSortIndicator(keys.front().column, keys.front().order);
+    // Источника ещё нет: порядок только запоминается до первой загрузки
+    if (std::optional<GameSort> sort = GameTableModel::serverSort(keys.front().column, keys.front().order)) {
+        gamesModel_->setSort(*sort);
     }
+}
+void MainWindow::applyServerSort() {
+    const std::vector<GameSortProxyModel::SortKey>& keys = gamesProxy_->sortKeys();
+    if (keys.empty()) return;
+    // Столбцы без серверного порядка сортируются только среди загруженных строк
+    std::optional<GameSort> sort = GameTableModel::serverSort(keys.front().column, keys.front().order);
+    if (!sort || *sort == gamesModel_->sort()) return;
+    // Модель перечитывается с первой страницы: отложенные правки должны быть уже в БД
+    flushPendingWrites();
+    lastClickedRow_ = -1;
+    gamesModel_->setSort(*sort);
     updateButtonStates();
-    updateStatusBar();
-    updateStats();
 }
-void MainWindow::updateStatusBar() {
-    QString status = QString("Игр в коллекции: %1").arg(gamesTable_->rowCount());
+void MainWindow::updateStatusBar(int gamesCount) {
+    QString status = QString("Игр в коллекции: %1").arg(gamesCount);
     if (filterActive_) {
         status += " (фильтр активен)";
     }
-    statusBar()->showMessage(status);
+    gamesCountLabel_->setText(status);
 }
-void MainWindow::updateStats() {
-    if (currentUser_.id == 0) return;
-    GameStats stats = dbManager_.getGameStats(currentUser_.id);
+void MainWindow::updateStats(const GameStats& stats) {
     QString statsText = QString(
         "★ Избранное: %1  |  ✓ Пройдено: %2  |  📊 Без оценки: %3  |  "
         "📥 Установлено: %4 (%5 ГБ)  |  🔗 Без ссылки: %6")
@@ -1307,20 +2014,34 @@ void MainWindow::updateStats() {
         .arg(stats.no_url_count);
     statsLabel_->setText(statsText);
 }
-void MainWindow::updateTagsCombo() {
+void MainWindow::updateTagsCombo(const std::vector<Tag>& tags) {
+    userTags_ = tags;
+    // Перезаполнение не должно запускать живую фильтрацию; выбор сохраняется
+    QSignalBlocker tagBlocker(filterTagCombo_);
+    QVariant selectedTag = filterTagCombo_->currentData();
     filterTagCombo_->clear();
     filterTagCombo_->addItem("Все теги", 0);
-    if (currentUser_.id == 0) return;
-    std::vector<Tag> tags = dbManager_.getUserTags(currentUser_.id);
     for (const auto& tag : tags) {
         filterTagCombo_->addItem(QString::fromStdString(tag.name), tag.id);
     }
+    filterTagCombo_->setCurrentIndex(std::max(0, filterTagCombo_->findData(selectedTag)));
+    if (lastFacets_) {
+        applyFacetCounts(*lastFacets_);
+    }
+}
+void MainWindow::updateGenresCombo(const std::vector<Genre>& genres) {
+    genres_ = genres;
+    QSignalBlocker genreBlocker(filterGenreCombo_);
+    QVariant selectedGenre = filterGenreCombo_->currentData();
     filterGenreCombo_->clear();
     filterGenreCombo_->addItem("Все жанры", 0);
-    std::vector<Genre> genres = dbManager_.getAllGenres();
     for (const auto& genre : genres) {
         filterGenreCombo_->addItem(QString::fromStdString(genre.name), genre.id);
     }
+    filterGenreCombo_->setCurrentIndex(std::max(0, filterGenreCombo_->findData(selectedGenre)));
+    if (lastFacets_) {
+        applyFacetCounts(*lastFacets_);
+    }
 }
 GameEditDialog::GameEditDialog(QWidget* parent, const Game* game)
     : QDialog(parent, Qt::Dialog | Qt::WindowTitleHint | Qt::WindowCloseButtonHint | Qt::WindowStaysOnTopHint)
@@ -1472,43 +2193,123 @@ Game GameEditDialog::getGame() const {
     game.notes = notesEdit_->toPlainText().toStdString();
     return game;
 }
-BinaryFileViewDialog::BinaryFileViewDialog(const std::vector<Game>& games, 
+BinaryFileViewDialog::BinaryFileViewDialog(DatabaseManager* dbManager,
                                            const QString& filename,
                                            QWidget* parent)
     : QDialog(parent, Qt::Dialog | Qt::WindowTitleHint | Qt::WindowCloseButtonHint | Qt::WindowStaysOnTopHint)
+    , dbManager_(dbManager)
+    , filename_(filename)
 {
     setWindowTitle("Просмотр бинарного файла");
     setMinimumSize(900, 550);
     setModal(true);
+    model_ = new BinaryFileModel(this);
+    fileOpen_ = model_->open(filename);
     QVBoxLayout* layout = new QVBoxLayout(this);
     QLabel* fileLabel = new QLabel(QString("Файл: %1").arg(QFileInfo(filename).fileName()));
-    QLabel* infoLabel = new QLabel(QString("Записей в файле: %1").arg(games.size()));
+    QLabel* infoLabel = new QLabel(QString("Записей в файле: %1").arg(model_->rowCount()));
+    verifyLabel_ = new QLabel();
+    verifyLabel_->setStyleSheet(QString("color: %1;").arg(TEXT_SECONDARY));
     layout->addWidget(fileLabel);
     layout->addWidget(infoLabel);
-    table_ = new QTableWidget();
-    table_->setColumnCount(7);
-    table_->setHorizontalHeaderLabels({
-        "Название", "Диск (ГБ)", "ОЗУ (ГБ)", "VRAM (ГБ)", "Жанр", "Пройдено", "Ссылка"
-    });
+    layout->addWidget(verifyLabel_);
+    QHBoxLayout* findLayout = new QHBoxLayout();
+    findEdit_ = new QLineEdit();
+    findEdit_->setPlaceholderText("Название игры (или его часть) либо ID");
+    QPushButton* findButton = new QPushButton("🔍 Найти");
+    jumpSpin_ = new QSpinBox();
+    jumpSpin_->setRange(1, std::max(1, model_->rowCount()));
+    jumpSpin_->setPrefix("№ ");
+    QPushButton* jumpButton = new QPushButton("Перейти");
+    findLayout->addWidget(findEdit_, 1);
+    findLayout->addWidget(findButton);
+    findLayout->addSpacing(20);
+    findLayout->addWidget(jumpSpin_);
+    findLayout->addWidget(jumpButton);
+    layout->addLayout(findLayout);
+    connect(findButton, &QPushButton::clicked, this, &BinaryFileViewDialog::onFind);
+    connect(findEdit_, &QLineEdit::returnPressed, this, &BinaryFileViewDialog::onFind);
+    connect(jumpButton, &QPushButton::clicked, this, &BinaryFileViewDialog::onJumpToRow);
+    table_ = new QTableView();
+    table_->setModel(model_);
+    table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table_->setSelectionMode(QAbstractItemView::SingleSelection);
     table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
     table_->horizontalHeader()->setStretchLastSection(true);
-    table_->setColumnWidth(0, 220);
-    table_->verticalHeader()->setVisible(false);
-    for (const auto& game : games) {
-        int row = table_->rowCount();
-        table_->insertRow(row);
-        table_->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(game.name)));
-        table_->setItem(row, 1, new QTableWidgetItem(QString::number(game.disk_space, 'f', 1)));
-        table_->setItem(row, 2, new QTableWidgetItem(QString::number(game.ram_usage, 'f', 1)));
-        table_->setItem(row, 3, new QTableWidgetItem(QString::number(game.vram_required, 'f', 1)));
-        table_->setItem(row, 4, new QTableWidgetItem(QString::fromStdString(game.genre)));
-        table_->setItem(row, 5, new QTableWidgetItem(game.completed ? "Да" : "Нет"));
-        table_->setItem(row, 6, new QTableWidgetItem(QString::fromStdString(game.url)));
-    }
+    table_->setColumnWidth(BinaryFileModel::ColName, 220);
+    // Фиксированная высота строк: представлению не нужно опрашивать каждую запись
+    table_->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table_->verticalHeader()->setDefaultSectionSize(table_->fontMetrics().height() + 8);
     layout->addWidget(table_);
     QPushButton* closeButton = new QPushButton("Закрыть");
     connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
     layout->addWidget(closeButton);
+    if (fileOpen_) {
+        startVerification();
+    }
+}
+void BinaryFileViewDialog::startVerification() {
+    using Verification = std::pair<FileVerificationResult, std::vector<uint32_t>>;
+    verifyLabel_->setText("Проверка целостности...");
+    auto* watcher = new QFutureWatcher<Verification>(this);
+    connect(watcher, &QFutureWatcher<Verification>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        Verification verification = watcher->result();
+        if (verification.first == FileVerificationResult::OK) {
+            verifyLabel_->setText("✓ Целостность подтверждена");
+        } else if (verification.first == FileVerificationResult::HASH_MISMATCH && !verification.second.empty()) {
+            model_->setDamagedRecords(verification.second);
+            verifyLabel_->setText(QString("⚠ Повреждено записей: %1 (выделены цветом)")
+                .arg(verification.second.size()));
+        } else {
+            verifyLabel_->setText(QString("⚠ Файл не прошел проверку: %1. Просмотр может быть некорректным.")
+                .arg(QString::fromStdString(DatabaseManager::getVerificationErrorText(verification.first))));
+        }
+    });
+    std::string path = filename_.toStdString();
+    watcher->setFuture(QtConcurrent::run([path]() {
+        // Свой экземпляр без подключения: фоновый поток не трогает общий DatabaseManager
+        DatabaseManager verifier;
+        Verification verification;
+        verification.first = verifier.quickCheckBinaryFile(path, &verification.second);
+        if (verification.first == FileVerificationResult::READ_ERROR) {
+            // Нет секции CRC (старый формат) — полная проверка SHA-256
+            verification.first = verifier.verifyBinaryFile(path);
+        }
+        return verification;
+    }));
+}
+void BinaryFileViewDialog::showRow(int row) {
+    table_->selectRow(row);
+    table_->scrollTo(model_->index(row, 0), QAbstractItemView::PositionAtCenter);
+    jumpSpin_->setValue(row + 1);
+}
+void BinaryFileViewDialog::onJumpToRow() {
+    if (model_->rowCount() == 0) return;
+    showRow(jumpSpin_->value() - 1);
+}
+void BinaryFileViewDialog::onFind() {
+    QString text = findEdit_->text().trimmed();
+    if (text.isEmpty()) return;
+    Game game;
+    uint32_t recordNo = 0;
+    bool isId = false;
+    int id = text.toInt(&isId);
+    bool found = dbManager_->lookupInBinaryFile(filename_.toStdString(), text.toStdString(), game, &recordNo);
+    if (!found && isId) {
+        found = dbManager_->lookupInBinaryFile(filename_.toStdString(), id, game, &recordNo);
+    }
+    int row = found && static_cast<int>(recordNo) < model_->rowCount() ? static_cast<int>(recordNo) : -1;
+    if (row < 0) {
+        // Точного совпадения нет — следующая запись, в названии которой есть текст
+        QModelIndex current = table_->currentIndex();
+        row = model_->findName(text, current.isValid() ? current.row() + 1 : 0);
+    }
+    if (row < 0) {
+        QMessageBox::information(this, "Поиск", QString("Запись \"%1\" не найдена.").arg(text));
+        return;
+    }
+    showRow(row);
 }
 AdminPanelDialog::AdminPanelDialog(DatabaseManager* dbManager, int adminUserId, QWidget* parent)
     : QDialog(parent, Qt::Dialog | Qt::WindowTitleHint | Qt::WindowCloseButtonHint | Qt::WindowStaysOnTopHint)
@@ -1539,16 +2340,20 @@ AdminPanelDialog::AdminPanelDialog(DatabaseManager* dbManager, int adminUserId,
     layout->addWidget(adminSettingsBox);
     QLabel* usersLabel = new QLabel("Зарегистрированные пользователи:");
     layout->addWidget(usersLabel);
-    usersTable_ = new QTableWidget();
-    usersTable_->setColumnCount(4);
-    usersTable_->setHorizontalHeaderLabels({"ID", "Имя пользователя", "Роль", "Игр"});
+    searchEdit_ = new QLineEdit();
+    searchEdit_->setPlaceholderText("🔍 Поиск по имени пользователя");
+    searchEdit_->setClearButtonEnabled(true);
+    layout->addWidget(searchEdit_);
+    usersModel_ = new UserListModel(this);
+    usersTable_ = new QTableView();
+    usersTable_->setModel(usersModel_);
     usersTable_->setSelectionBehavior(QAbstractItemView::SelectRows);
-    usersTable_->setSelectionMode(QAbstractItemView::SingleSelection);
+    usersTable_->setSelectionMode(QAbstractItemView::ExtendedSelection);
     usersTable_->setEditTriggers(QAbstractItemView::NoEditTriggers);
     usersTable_->horizontalHeader()->setStretchLastSection(true);
-    usersTable_->setColumnWidth(0, 50);
-    usersTable_->setColumnWidth(1, 200);
-    usersTable_->setColumnWidth(2, 150);
+    usersTable_->setColumnWidth(UserListModel::ColId, 50);
+    usersTable_->setColumnWidth(UserListModel::ColUsername, 200);
+    usersTable_->setColumnWidth(UserListModel::ColRole, 150);
     usersTable_->verticalHeader()->setVisible(false);
     layout->addWidget(usersTable_);
     QHBoxLayout* buttonLayout = new QHBoxLayout();
@@ -1567,58 +2372,118 @@ AdminPanelDialog::AdminPanelDialog(DatabaseManager* dbManager, int adminUserId,
     connect(changePasswordButton_, &QPushButton::clicked, this, &AdminPanelDialog::onChangePassword);
     connect(resetAdminButton_, &QPushButton::clicked, this, &AdminPanelDialog::onResetAdmin);
     connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
-    connect(usersTable_, &QTableWidget::itemSelectionChanged, [this]() {
-        int row = usersTable_->currentRow();
-        if (row >= 0) {
-            QString role = usersTable_->item(row, 2)->text();
-            deleteButton_->setEnabled(role != "Администратор");
+    connect(usersTable_->selectionModel(), &QItemSelectionModel::selectionChanged,
+            this, &AdminPanelDialog::updateDeleteButton);
+    connect(usersModel_, &UserListModel::pageRequested, this, &AdminPanelDialog::onPageRequested);
+    searchDebounce_ = new QTimer(this);
+    searchDebounce_->setSingleShot(true);
+    searchDebounce_->setInterval(250);
+    connect(searchEdit_, &QLineEdit::textChanged, searchDebounce_, QOverload<>::of(&QTimer::start));
+    connect(searchDebounce_, &QTimer::timeout, this, &AdminPanelDialog::updateUsersList);
+    loaderPool_.setMaxThreadCount(1);
+    // Без второго подключения страницы грузятся синхронно через основное
+    loaderDb_.connectSecondary(*dbManager_);
+    updateUsersList();
+}
+void AdminPanelDialog::updateUsersList() {
+    ++pageGeneration_;
+    usersModel_->reset();
+    updateDeleteButton();
+    usersModel_->fetchMore(QModelIndex());
+}
+void AdminPanelDialog::onPageRequested(const UserPageKey& after) {
+    std::string search = searchEdit_->text().trimmed().toStdString();
+    if (!loaderDb_.isConnected()) {
+        bool ok = false;
+        std::vector<UserSummary> page = dbManager_->getUserSummariesPage(search, after, UserListModel::PAGE_SIZE, &ok);
+        if (ok) {
+            usersModel_->appendPage(std::move(page));
+        } else {
+            showPageError(dbManager_->getLastError());
+        }
+        return;
+    }
+    int generation = pageGeneration_;
+    DatabaseManager* db = &loaderDb_;
+    // Текст ошибки снимается в рабочем потоке, пока соединение не занято следующим запросом
+    auto error = std::make_shared<std::string>();
+    auto* watcher = new QFutureWatcher<std::optional<std::vector<UserSummary>>>(this);
+    connect(watcher, &QFutureWatcher<std::optional<std::vector<UserSummary>>>::finished, this,
+            [this, watcher, generation, error]() {
+        watcher->deleteLater();
+        if (generation != pageGeneration_) return;
+        std::optional<std::vector<UserSummary>> page = watcher->result();
+        if (page) {
+            usersModel_->appendPage(std::move(*page));
         } else {
-            deleteButton_->setEnabled(false);
+            showPageError(*error);
         }
     });
-    updateUsersList();
+    watcher->setFuture(QtConcurrent::run(&loaderPool_, [db, search, after, error]() {
+        std::optional<std::vector<UserSummary>> result;
+        bool ok = false;
+        std::vector<UserSummary> page = db->getUserSummariesPage(search, after, UserListModel::PAGE_SIZE, &ok);
+        if (ok) {
+            result = std::move(page);
+        } else {
+            *error = db->getLastError();
+        }
+        return result;
+    }));
 }
-void AdminPanelDialog::updateUsersList() {
-    usersTable_->setRowCount(0);
-    std::vector<User> users = dbManager_->getAllUsers();
-    for (const auto& user : users) {
-        int row = usersTable_->rowCount();
-        usersTable_->insertRow(row);
-        usersTable_->setItem(row, 0, new QTableWidgetItem(QString::number(user.id)));
-        usersTable_->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(user.username)));
-        usersTable_->setItem(row, 2, new QTableWidgetItem(user.is_admin ? "Администратор" : "Пользователь"));
-        int gamesCount = dbManager_->getUserGamesCount(user.id);
-        usersTable_->setItem(row, 3, new QTableWidgetItem(QString::number(gamesCount)));
-        if (user.is_admin) {
-            for (int col = 0; col < usersTable_->columnCount(); ++col) {
-                usersTable_->item(row, col)->setForeground(QColor(ACCENT_COLOR));
-            }
+void AdminPanelDialog::showPageError(const std::string& error) {
+    // Ошибка — не конец списка: следующая прокрутка запросит страницу снова
+    usersModel_->pageFailed();
+    QMessageBox::warning(this, "Ошибка",
+        QString("Не удалось загрузить пользователей: %1").arg(QString::fromStdString(error)));
+}
+std::vector<UserSummary> AdminPanelDialog::selectedUsers() const {
+    std::vector<UserSummary> users;
+    for (const QModelIndex& index : usersTable_->selectionModel()->selectedRows()) {
+        const UserSummary& user = usersModel_->userAt(index.row());
+        if (!user.is_admin) {
+            users.push_back(user);
         }
     }
+    return users;
+}
+void AdminPanelDialog::updateDeleteButton() {
+    size_t count = selectedUsers().size();
+    deleteButton_->setEnabled(count > 0);
+    deleteButton_->setText(count > 1 ? QString("🗑️ Удалить пользователей (%1)").arg(count)
+                                     : QString("🗑️ Удалить пользователя"));
 }
 void AdminPanelDialog::onDeleteUser() {
-    int row = usersTable_->currentRow();
-    if (row < 0) return;
-    QString username = usersTable_->item(row, 1)->text();
-    int userId = usersTable_->item(row, 0)->text().toInt();
-    int gamesCount = usersTable_->item(row, 3)->text().toInt();
-    QString message = QString("Вы уверены, что хотите удалить пользователя \"%1\"?").arg(username);
+    std::vector<UserSummary> users = selectedUsers();
+    if (users.empty()) return;
+    std::vector<int> userIds;
+    int gamesCount = 0;
+    for (const auto& user : users) {
+        userIds.push_back(user.id);
+        gamesCount += user.games_count;
+    }
+    QString message;
+    if (users.size() == 1) {
+        message = QString("Вы уверены, что хотите удалить пользователя \"%1\"?")
+            .arg(QString::fromStdString(users.front().username));
+    } else {
+        message = QString("Вы уверены, что хотите удалить выбранных пользователей (%1)?").arg(userIds.size());
+    }
     if (gamesCount > 0) {
-        message += QString("
-Внимание: будут также удалены все %1 игр(ы) этого пользователя!").arg(gamesCount);
+        message += QString("\nВнимание: будут также удалены все %1 игр(ы) этих пользователей!").arg(gamesCount);
     }
     QMessageBox::StandardButton reply = QMessageBox::question(this, "Подтверждение удаления",
         message, QMessageBox::Yes | QMessageBox::No);
-    if (reply == QMessageBox::Yes) {
-        if (dbManager_->deleteUser(userId)) {
-            updateUsersList();
-            QMessageBox::information(this, "Успех", 
-                QString("Пользователь \"%1\" удален").arg(username));
-        } else {
-            QMessageBox::critical(this, "Ошибка", 
-                QString("Не удалось удалить пользователя: %1")
-                    .arg(QString::fromStdString(dbManager_->getLastError())));
-        }
+    if (reply != QMessageBox::Yes) return;
+    int deleted = dbManager_->deleteUsers(userIds);
+    if (deleted >= 0) {
+        usersModel_->removeUsers(userIds);
+        updateDeleteButton();
+        QMessageBox::information(this, "Успех", QString("Удалено пользователей: %1").arg(deleted));
+    } else {
+        QMessageBox::critical(this, "Ошибка", 
+            QString("Не удалось удалить пользователей: %1")
+                .arg(QString::fromStdString(dbManager_->getLastError())));
     }
 }
 void AdminPanelDialog::onRefresh() {
@@ -1655,14 +2520,7 @@ void AdminPanelDialog::onChangeUsername() {
         QMessageBox::warning(this, "Ошибка", "Логин должен содержать минимум 3 символа!");
         return;
     }
-    std::vector<User> users = dbManager_->getAllUsers();
-    QString adminUsername;
-    for (const auto& user : users) {
-        if (user.id == adminUserId_) {
-            adminUsername = QString::fromStdString(user.username);
-            break;
-        }
-    }
+    QString adminUsername = QString::fromStdString(dbManager_->getUsername(adminUserId_));
     std::string currentHash = HashUtils::hashPassword(password.toStdString(), adminUsername.toStdString());
     User verifyUser = dbManager_->authenticateUser(adminUsername.toStdString(), currentHash);
     if (verifyUser.id == 0) {
@@ -1721,14 +2579,7 @@ void AdminPanelDialog::onChangePassword() {
         QMessageBox::warning(this, "Ошибка", "Пароль должен содержать минимум 4 символа!");
         return;
     }
-    std::vector<User> users = dbManager_->getAllUsers();
-    QString adminUsername;
-    for (const auto& user : users) {
-        if (user.id == adminUserId_) {
-            adminUsername = QString::fromStdString(user.username);
-            break;
-        }
-    }
+    QString adminUsername = QString::fromStdString(dbManager_->getUsername(adminUserId_));
     std::string currentHash = HashUtils::hashPassword(currentPassword.toStdString(), adminUsername.toStdString());
     User verifyUser = dbManager_->authenticateUser(adminUsername.toStdString(), currentHash);
     if (verifyUser.id == 0) {
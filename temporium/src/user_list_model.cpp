@@ -0,0 +1,89 @@
+#include "user_list_model.h"
+#include "theme.h"
+#include <QColor>
+#include <QStringList>
+#include <algorithm>
+#include <iterator>
+namespace Temporium {
+static const QColor ADMIN_COLOR(ACCENT_COLOR);
+UserListModel::UserListModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+int UserListModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(users_.size());
+}
+int UserListModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+QVariant UserListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+    const UserSummary& user = users_[static_cast<size_t>(index.row())];
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case ColId:       return user.id;
+        case ColUsername: return QString::fromStdString(user.username);
+        case ColRole:     return user.is_admin ? QStringLiteral("Администратор") : QStringLiteral("Пользователь");
+        case ColGames:    return user.games_count;
+        }
+        break;
+    case Qt::ForegroundRole:
+        if (user.is_admin) return ADMIN_COLOR;
+        break;
+    }
+    return QVariant();
+}
+QVariant UserListModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    static const QStringList headers = {"ID", "Имя пользователя", "Роль", "Игр"};
+    return section >= 0 && section < headers.size() ? headers[section] : QVariant();
+}
+bool UserListModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && hasMore_ && !loading_;
+}
+void UserListModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent)) return;
+    UserPageKey after;
+    if (!users_.empty()) {
+        after.valid = true;
+        after.username = users_.back().username;
+    }
+    loading_ = true;
+    emit pageRequested(after);
+}
+void UserListModel::reset() {
+    beginResetModel();
+    users_.clear();
+    hasMore_ = true;
+    loading_ = false;
+    endResetModel();
+}
+void UserListModel::appendPage(std::vector<UserSummary> page) {
+    loading_ = false;
+    hasMore_ = page.size() == static_cast<size_t>(PAGE_SIZE);
+    if (page.empty()) return;
+    int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(page.size()) - 1);
+    users_.insert(users_.end(), std::make_move_iterator(page.begin()), std::make_move_iterator(page.end()));
+    endInsertRows();
+}
+void UserListModel::pageFailed() {
+    loading_ = false;
+}
+void UserListModel::removeUsers(const std::vector<int>& userIds) {
+    // С конца, чтобы номера ещё не удалённых строк не сдвигались
+    for (int row = rowCount() - 1; row >= 0; --row) {
+        int id = users_[static_cast<size_t>(row)].id;
+        if (std::find(userIds.begin(), userIds.end(), id) != userIds.end()) {
+            beginRemoveRows(QModelIndex(), row, row);
+            users_.erase(users_.begin() + row);
+            endRemoveRows();
+        }
+    }
+}
+} // namespace Temporium
@@ -0,0 +1,86 @@
+#include "binary_copy_reader.h"
+#include "fake_libpq.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+using Temporium::BinaryCopyReader;
+// Проверки разбора двоичного COPY на подменённой libpq (fake_libpq.cpp): без сервера
+static int failures = 0;
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+static void putInt16(std::string& out, int16_t value) {
+    out += static_cast<char>((value >> 8) & 0xff);
+    out += static_cast<char>(value & 0xff);
+}
+static void putInt32(std::string& out, int32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out += static_cast<char>((value >> shift) & 0xff);
+    }
+}
+static std::string copyHeader() {
+    std::string header("PGCOPY\n\377\r\n", 11);
+    putInt32(header, 0);
+    putInt32(header, 0);
+    return header;
+}
+// Кортеж (int4 id, text name)
+static std::string copyTuple(int32_t id, const std::string& name) {
+    std::string tuple;
+    putInt16(tuple, 2);
+    putInt32(tuple, 4);
+    putInt32(tuple, id);
+    putInt32(tuple, static_cast<int32_t>(name.size()));
+    tuple += name;
+    return tuple;
+}
+static std::string copyTrailer() {
+    std::string trailer;
+    putInt16(trailer, -1);
+    return trailer;
+}
+// COPY до конца: признак конца данных приходит отдельным сообщением, после него
+// поток нужно дочитать до -1, иначе PQgetResult не выходит из COPY OUT
+static void testCopyToEnd() {
+    FakeLibpq::setCopyMessages({copyHeader() + copyTuple(1, "Half-Life"), copyTuple(2, "Portal"), copyTrailer()});
+    {
+        BinaryCopyReader reader("fake");
+        check(reader.start("SELECT id, name FROM games"), "start");
+        std::vector<std::string> names;
+        while (reader.next()) {
+            check(reader.fieldCount() == 2, "field count");
+            names.emplace_back(reader.text(1));
+        }
+        check(!reader.failed(), "no error at end of data");
+        check(names == std::vector<std::string>{"Half-Life", "Portal"}, "all rows read");
+        check(!reader.next(), "next after end");
+        check(reader.exec("COMMIT"), "connection usable after COPY");
+    }
+    check(FakeLibpq::outstandingBuffers() == 0, "copy buffers freed");
+}
+// Обрезанный кортеж: ошибка, остаток потока вычитывается, буферы освобождены
+static void testTruncatedTuple() {
+    std::string broken = copyTuple(3, "Doom");
+    broken.resize(broken.size() - 2);
+    FakeLibpq::setCopyMessages({copyHeader() + copyTuple(1, "Quake"), broken, copyTuple(4, "Thief"), copyTrailer()});
+    {
+        BinaryCopyReader reader("fake");
+        check(reader.start("SELECT id, name FROM games"), "start");
+        check(reader.next() && reader.int4(0) == 1, "first row");
+        check(!reader.next(), "stops at broken tuple");
+        check(reader.failed(), "broken tuple reported");
+        check(reader.exec("COMMIT"), "connection usable after error");
+    }
+    check(FakeLibpq::outstandingBuffers() == 0, "copy buffers freed after error");
+}
+int main() {
+    testCopyToEnd();
+    testTruncatedTuple();
+    if (failures == 0) {
+        std::printf("binary_copy_reader_test: OK\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
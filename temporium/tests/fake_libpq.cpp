@@ -0,0 +1,100 @@
+#include "fake_libpq.h"
+#include <libpq-fe.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+// Подмена libpq для проверок без сервера: одно соединение, выполнение команд и COPY OUT.
+// Как настоящая libpq, PQgetResult во время COPY OUT снова и снова возвращает
+// PGRES_COPY_OUT, пока поток не дочитан PQgetCopyData до -1
+struct pg_conn {
+    enum State { Idle, CopyOut, CopyDone } state = Idle;
+    size_t next = 0;
+};
+struct pg_result {
+    ExecStatusType status;
+};
+namespace FakeLibpq {
+static std::vector<std::string> copyMessages;
+static int buffers = 0;
+static int copyOutResults = 0;
+// Столько PGRES_COPY_OUT подряд бывает только при бесконечном цикле у вызывающего
+static constexpr int COPY_OUT_RESULT_LIMIT = 1000;
+void setCopyMessages(std::vector<std::string> messages) {
+    copyMessages = std::move(messages);
+}
+int outstandingBuffers() {
+    return buffers;
+}
+static PGresult* makeResult(ExecStatusType status) {
+    return new pg_result{status};
+}
+} // namespace FakeLibpq
+using namespace FakeLibpq;
+PGconn* PQconnectdb(const char*) {
+    return new pg_conn;
+}
+ConnStatusType PQstatus(const PGconn* conn) {
+    return conn ? CONNECTION_OK : CONNECTION_BAD;
+}
+char* PQerrorMessage(const PGconn*) {
+    static char message[] = "fake libpq error";
+    return message;
+}
+void PQfinish(PGconn* conn) {
+    delete conn;
+}
+PGresult* PQexec(PGconn* conn, const char* query) {
+    if (std::strncmp(query, "COPY", 4) == 0) {
+        conn->state = pg_conn::CopyOut;
+        conn->next = 0;
+        copyOutResults = 0;
+        return makeResult(PGRES_COPY_OUT);
+    }
+    return makeResult(PGRES_COMMAND_OK);
+}
+ExecStatusType PQresultStatus(const PGresult* res) {
+    return res ? res->status : PGRES_FATAL_ERROR;
+}
+char* PQresultErrorMessage(const PGresult*) {
+    static char message[] = "";
+    return message;
+}
+void PQclear(PGresult* res) {
+    delete res;
+}
+int PQgetCopyData(PGconn* conn, char** buffer, int) {
+    *buffer = nullptr;
+    if (conn->state != pg_conn::CopyOut) return -2;
+    if (conn->next == copyMessages.size()) {
+        conn->state = pg_conn::CopyDone;
+        return -1;
+    }
+    const std::string& message = copyMessages[conn->next++];
+    *buffer = static_cast<char*>(std::malloc(message.size() + 1));
+    std::memcpy(*buffer, message.data(), message.size());
+    ++buffers;
+    return static_cast<int>(message.size());
+}
+PGresult* PQgetResult(PGconn* conn) {
+    switch (conn->state) {
+    case pg_conn::CopyOut:
+        if (++copyOutResults > COPY_OUT_RESULT_LIMIT) {
+            std::fprintf(stderr, "PQgetResult called in COPY OUT state %d times: caller loops forever\n",
+                         copyOutResults);
+            std::exit(1);
+        }
+        return makeResult(PGRES_COPY_OUT);
+    case pg_conn::CopyDone:
+        conn->state = pg_conn::Idle;
+        return makeResult(PGRES_COMMAND_OK);
+    case pg_conn::Idle:
+        break;
+    }
+    return nullptr;
+}
+void PQfreemem(void* ptr) {
+    if (ptr) {
+        --buffers;
+        std::free(ptr);
+    }
+}
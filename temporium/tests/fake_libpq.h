@@ -0,0 +1,16 @@
+#ifndef FAKE_LIBPQ_H
+#define FAKE_LIBPQ_H
+
+#include <string>
+#include <vector>
+
+namespace FakeLibpq {
+
+// Сообщения CopyData, которые отдаст следующий COPY ... TO STDOUT
+void setCopyMessages(std::vector<std::string> messages);
+// Буферы PQgetCopyData, ещё не возвращённые через PQfreemem
+int outstandingBuffers();
+
+} // namespace FakeLibpq
+
+#endif // FAKE_LIBPQ_H